@@ -0,0 +1,105 @@
+//
+// Copyright (C) 2017-2024 Tactical Computing Laboratories, LLC
+// All Rights Reserved
+// contact@tactcomplabs.com
+// See LICENSE in the top level directory for licensing details
+//
+
+// clang-format off
+#include <sst/core/sst_config.h>
+#include "PIMAtomic.h"
+#include "memEventCustom.h"
+#include "tclpim_kernels.h"
+#include <sstream>
+// clang-format on
+
+using namespace SST;
+using namespace SST::MemHierarchy;
+
+namespace SST::PIM {
+
+namespace {
+
+// Apply op to the little-endian value in mem and return the old value
+template<typename T>
+uint64_t applyAtomic( PIMAtomicData* d, std::vector<uint8_t>& mem ) {
+  T old;
+  std::memcpy( &old, mem.data(), sizeof( T ) );
+  T v = kernels::atomicApply<T>(
+    d->op, old, kernels::fromBits<T>( d->operand ), kernels::fromBits<T>( d->compare )
+  );
+  std::memcpy( mem.data(), &v, sizeof( T ) );
+  uint64_t bits = 0;
+  std::memcpy( &bits, &old, sizeof( T ) );
+  return bits;
+}
+
+}  // namespace
+
+std::string PIMAtomicData::getString() {
+  std::stringstream s;
+  s << "PIMAtomic op=" << static_cast<int>( op ) << " addr=0x" << std::hex << addr << " size=" << std::dec << size
+    << " operand=0x" << std::hex << operand << " compare=0x" << compare << " result=0x" << result;
+  return s.str();
+}
+
+PIMAtomicHandler::PIMAtomicHandler(
+  ComponentId_t                                                 id,
+  Params&                                                       params,
+  std::function<void( Addr, size_t, std::vector<uint8_t>& )> read,
+  std::function<void( Addr, std::vector<uint8_t>* )>         write
+)
+  : CustomCmdMemHandler( id, params, read, write ), readMem( read ), writeMem( write ) {
+  const int Verbosity = params.find<int>( "verbose", 0 );
+  out.init( "PIMAtomic[" + getName() + ":@p:@t]: ", Verbosity, 0, SST::Output::STDOUT );
+  decoder = new PIMDecoder( params.find<unsigned>( "node_id", 0 ) );
+}
+
+PIMAtomicHandler::~PIMAtomicHandler() {
+  out.verbose( CALL_INFO, 1, 0, "Executed %" PRIu64 " atomics\n", numAtomics );
+  delete decoder;
+}
+
+CustomCmdMemHandler::MemEventInfo PIMAtomicHandler::receive( MemEventBase* ev ) {
+  CustomMemEvent*                      cev  = static_cast<CustomMemEvent*>( ev );
+  Interfaces::StandardMem::CustomData* data = cev->getCustomData();
+  PIMAtomicData*                       a    = dynamic_cast<PIMAtomicData*>( data );
+  if( a ) {
+    if( a->size != 1 && a->size != 2 && a->size != 4 && a->size != 8 )
+      out.fatal( CALL_INFO, -1, "PIM atomic size must be 1, 2, 4 or 8 bytes: %s\n", a->getString().c_str() );
+    if( a->addr % a->size )
+      out.fatal( CALL_INFO, -1, "PIM atomic must be naturally aligned: %s\n", a->getString().c_str() );
+    // SRAM and function registers live in the PIM, not in the backing store
+    if( decoder->decode( a->addr ).isIO )
+      out.fatal( CALL_INFO, -1, "PIM atomic targets a PIM MMIO address: %s\n", a->getString().c_str() );
+  }
+  return MemEventInfo( std::set<Addr>{ data->getRoutingAddress() }, false );
+}
+
+Interfaces::StandardMem::CustomData* PIMAtomicHandler::ready( MemEventBase* ev ) {
+  return static_cast<CustomMemEvent*>( ev )->getCustomData();
+}
+
+MemEventBase* PIMAtomicHandler::finish( MemEventBase* ev, uint32_t flags ) {
+  CustomMemEvent* cev = static_cast<CustomMemEvent*>( ev );
+  PIMAtomicData*  a   = dynamic_cast<PIMAtomicData*>( cev->getCustomData() );
+  if( a ) {
+    // The read-modify-write is applied once the backend access completes
+    std::vector<uint8_t> mem;
+    readMem( a->addr, a->size, mem );
+    switch( a->size ) {
+    case 1: a->result = applyAtomic<int8_t>( a, mem ); break;
+    case 2: a->result = applyAtomic<int16_t>( a, mem ); break;
+    case 4: a->result = applyAtomic<int32_t>( a, mem ); break;
+    default: a->result = applyAtomic<int64_t>( a, mem ); break;
+    }
+    writeMem( a->addr, &mem );
+    numAtomics++;
+    out.verbose( CALL_INFO, 3, 0, "%s\n", a->getString().c_str() );
+  }
+  if( ev->queryFlag( MemEventBase::F_NORESPONSE ) || !cev->getCustomData()->needsResponse() )
+    return nullptr;
+  return cev->makeResponse();
+}
+
+}  // namespace SST::PIM
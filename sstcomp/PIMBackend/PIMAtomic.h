@@ -0,0 +1,105 @@
+//
+// Copyright (C) 2017-2024 Tactical Computing Laboratories, LLC
+// All Rights Reserved
+// contact@tactcomplabs.com
+// See LICENSE in the top level directory for licensing details
+//
+
+#ifndef _H_SST_PIM_ATOMIC_
+#define _H_SST_PIM_ATOMIC_
+
+// clang-format off
+#include <sst/core/interfaces/stdMem.h>
+#include "sst/elements/memHierarchy/customcmd/customCmdMemory.h"
+#include "PIMDecoder.h"
+#include "pimdef.h"
+#include <functional>
+#include <string>
+#include <vector>
+// clang-format on
+
+namespace SST::PIM {
+
+using namespace SST::MemHierarchy;
+
+// Payload of a near-memory atomic custom request. The response carries the
+// same object back with the old memory value in result.
+class PIMAtomicData : public Interfaces::StandardMem::CustomData {
+public:
+  PIMAtomicData() {}
+
+  PIMAtomicData( ATOMIC_OP op, Addr addr, unsigned size, uint64_t operand, uint64_t compare = 0 )
+    : op( op ), addr( addr ), size( size ), operand( operand ), compare( compare ) {}
+
+  Addr     getRoutingAddress() override { return addr; }
+  uint64_t getSize() override { return size; }
+  bool     needsResponse() override { return true; }
+  std::string getString() override;
+
+  // The controller fills in result on the request object, so the response is the request
+  CustomData* makeResponse() override { return this; }
+
+  ATOMIC_OP op      = ATOMIC_OP::ADD;
+  Addr      addr    = 0;
+  unsigned  size    = 8;
+  uint64_t  operand = 0;
+  uint64_t  compare = 0;
+  uint64_t  result  = 0;
+
+  void serialize_order( SST::Core::Serialization::serializer& ser ) override {
+    ser & op;
+    ser & addr;
+    ser & size;
+    ser & operand;
+    ser & compare;
+    ser & result;
+  }
+
+  ImplementSerializable( SST::PIM::PIMAtomicData );
+};
+
+// Memory controller custom command handler that executes PIMAtomicData
+// requests against the backing store. Other custom payloads pass through
+// untouched, as with the default handler. The handler is loaded with the
+// memory controller's params, so it sees the controller's node_id. Its
+// read and write callbacks take global addresses; the controller maps them
+// to the local backing store as it does for ordinary requests.
+class PIMAtomicHandler : public CustomCmdMemHandler {
+public:
+  SST_ELI_REGISTER_SUBCOMPONENT(
+    PIMAtomicHandler,
+    "PIM",
+    "PIMAtomicHandler",
+    SST_ELI_ELEMENT_VERSION( 1, 0, 0 ),
+    "Near-memory atomic fetch-and-op custom commands",
+    SST::MemHierarchy::CustomCmdMemHandler
+  )
+
+  SST_ELI_DOCUMENT_PARAMS(
+    { "verbose", "Sets the verbosity of the handler output", "0" },
+    { "node_id", "Node whose PIM MMIO window atomics may not target", "0" }
+  )
+
+  PIMAtomicHandler(
+    ComponentId_t                                                 id,
+    Params&                                                       params,
+    std::function<void( Addr, size_t, std::vector<uint8_t>& )> read,
+    std::function<void( Addr, std::vector<uint8_t>* )>         write
+  );
+  ~PIMAtomicHandler();
+
+  MemEventInfo                         receive( MemEventBase* ev ) override;
+  Interfaces::StandardMem::CustomData* ready( MemEventBase* ev ) override;
+  MemEventBase*                        finish( MemEventBase* ev, uint32_t flags ) override;
+
+private:
+  SST::Output                                                 out;
+  std::function<void( Addr, size_t, std::vector<uint8_t>& )> readMem;
+  std::function<void( Addr, std::vector<uint8_t>* )>         writeMem;
+  PIMDecoder*                                                 decoder;
+  uint64_t                                                    numAtomics = 0;
+};
+
+}  // namespace SST::PIM
+
+#endif  //_H_SST_PIM_ATOMIC_
@@ -90,7 +90,7 @@ PIMBackend::PIMBackend( ComponentId_t id, Params& params ) : SimpleMemBackend( i
   if( pim_type == PIM_TYPE_TEST ) {
     pimOutput.fatal(CALL_INFO,-1,"pim_type PIM_TYPE_TEST is deprecated. Used PIM_TYPE_TCL instead\n");
   } else if( pim_type == PIM_TYPE_TCL ) {
-    pimsim = new TCLPIM( node_id, &pimOutput );
+    pimsim = new TCLPIM( node_id, &pimOutput, params );
     pimOutput.verbose( CALL_INFO, 1, 0, "pim_type=%" PRIu32 " Node=%" PRIu32 " Using TCL PIM\n", PIM_TYPE_TCL, node_id );
   } else if( pim_type == PIM_TYPE_RESERVE ) {
     pimOutput.fatal( CALL_INFO, -1, "PIM_TYPE_RESERVED not supported\n" );
@@ -132,6 +132,12 @@ bool PIMBackend::issueRequest( ReqId req, Addr addr, bool isWrite, unsigned numB
   }
 }
 
+bool PIMBackend::issueCustomRequest( ReqId req, Interfaces::StandardMem::CustomData* data ) {
+  // Near-memory atomics are timed as a DRAM read of the operand. The write back
+  // hits the open row, and the handler applies the update when the read returns.
+  return issueRequest( req, data->getRoutingAddress(), false, data->getSize() );
+}
+
 /*
  * Call throughs to our backend
  */
@@ -141,8 +147,10 @@ bool PIMBackend::clock( Cycle_t cycle ) {
   // Clock our PIM and Backend
   // TODO check if clocking on before clocking
   bool unclockPIM = false;
-  if( pimsim )
+  if( pimsim ) {
     unclockPIM = pimsim->clock( cycle );
+    releaseMMIOResponses();
+  }
   bool unclockBackend = backend->clock( cycle );
 
   if( pimsim && !initDRAMDone ) {
@@ -162,7 +170,7 @@ bool PIMBackend::clock( Cycle_t cycle ) {
     m_pimRequest( evr );
   }
 
-  return unclockPIM && unclockBackend;
+  return unclockPIM && unclockBackend && heldMMIOResponses.empty();
 }
 
 void PIMBackend::handleMemReponse( ReqId id ) {
@@ -235,14 +243,35 @@ void PIMBackend::handlePIMCompletion( SST::Event* resp ) {
   delete resp;  // Event completed.
 }
 
-void PIMBackend::handleMMIOReadCompletion( SST::Event* ev ) {
+bool PIMBackend::handleMMIOReadCompletion( SST::Event* ev ) {
   assert( pimsim );
   MemEvent* mev = static_cast<MemEvent*>( ev );
+  // Blocking status registers respond later from clock()
+  if( !pimsim->readReady( mev->getAddr() ) ) {
+    pimOutput.verbose(CALL_INFO,3,0,"MMIO read a=0x%" PRIx64 " held until ready\n", mev->getAddr());
+    return false;
+  }
   // place PIM data in event payload
   buffer.resize( mev->getSize() );
   pimsim->read( mev->getAddr(), mev->getSize(), buffer );
   mev->setPayload( buffer );
   pimOutput.verbose(CALL_INFO,3,0,"MMIO read a=0x%" PRIx64 "d[0]=%" PRId32 "\n", mev->getAddr(), (int)buffer[0]);
+  return true;
+}
+
+void PIMBackend::holdMMIOResponse( SST::Event* ev ) {
+  heldMMIOResponses.push_back( static_cast<MemEvent*>( ev ) );
+}
+
+void PIMBackend::releaseMMIOResponses() {
+  for( auto it = heldMMIOResponses.begin(); it != heldMMIOResponses.end(); ) {
+    if( !handleMMIOReadCompletion( *it ) ) {
+      ++it;
+      continue;
+    }
+    m_mmioResponse( *it );
+    it = heldMMIOResponses.erase( it );
+  }
 }
 
 void PIMBackend::handleMMIOWriteCompletion( SST::Event* ev ) {
@@ -12,6 +12,7 @@
 #include "sst/elements/memHierarchy/membackend/memBackend.h"
 #include "pim.h"
 #include "memEvent.h"
+#include <list>
 #include <queue>
 // clang-format on
 
@@ -44,6 +45,25 @@ public:
     { "request_delay", "Constant delay to be added to requests with units (e.g., 1us)", "0ns" },
     { "pim_type", "1:test mode, 2:reserved, 3:tclpim", "1" },
     { "num_nodes", "Number of nodes", "1" },
+    { "dma_max_reads", "tclpim: maximum in-flight DRAM read chunks per DMA engine", "4" },
+    { "dma_max_writes", "tclpim: maximum in-flight DRAM write chunks per DMA engine", "4" },
+    { "dma_chunk_bytes", "tclpim: bytes per DMA DRAM request (multiple of 8)", "512" },
+    { "dma_tile_bytes", "tclpim: largest tile the 2-D DMA can transpose in flight", "4096" },
+    { "gs_burst_bytes", "tclpim: gather/scatter coalescing granule in bytes (power of 2)", "64" },
+    { "gs_max_outstanding", "tclpim: maximum in-flight gather/scatter element requests", "16" },
+    { "hash_max_probes", "tclpim: maximum hash table probes in flight", "16" },
+    { "sort_lanes", "tclpim: sort compare-exchange units, also records merged per cycle", "8" },
+    { "hist_updates", "tclpim: histogram SRAM bin updates per cycle", "4" },
+    { "spmv_window", "tclpim: SpMV nonzeros in flight waiting on x", "64" },
+    { "spmv_lanes", "tclpim: SpMV nonzeros admitted and retired per cycle", "2" },
+    { "gemv_buffer_bytes", "tclpim: GEMV weight bytes per ping-pong buffer (at least one row)", "1024" },
+    { "gemv_macs", "tclpim: GEMV multiply-accumulates per cycle", "16" },
+    { "codec_block_cycles", "tclpim: compress/decompress setup cycles per block", "2" },
+    { "codec_encode_words", "tclpim: words compressed per cycle", "4" },
+    { "codec_decode_words", "tclpim: words decompressed per cycle", "8" },
+    { "sls_lanes", "tclpim: SLS embedding row elements pooled per cycle", "16" },
+    { "stencil_rows", "tclpim: stencil SRAM ring depth in rows", "6" },
+    { "stencil_lanes", "tclpim: stencil outputs computed per cycle", "8" },
   )
 
   SST_ELI_DOCUMENT_SUBCOMPONENT_SLOTS( { "backend", "Backend memory model", "SST::MemHierarchy::SimpleMemBackend" } )
@@ -53,12 +73,16 @@ public:
   PIMBackend( ComponentId_t id, Params& params );
   virtual ~PIMBackend();
   virtual bool issueRequest( ReqId, Addr, bool isWrite, unsigned numBytes ) override;
+  virtual bool issueCustomRequest( ReqId, Interfaces::StandardMem::CustomData* ) override;
 
   virtual std::string getBackendConvertorType() override { return "memHierarchy.simpleMemBackendConvertor"; }
 
   // PIM Callbacks for memory controller event injection from PIM and response to PIM. Map to MemController::handleEvent
   virtual void setEventInjectionHandler( std::function<void( SST::Event* )> handler ) { m_pimRequest = handler; }
 
+  // Memory controller callback to send an MMIO read response that was held by the PIM
+  virtual void setMMIOResponseHandler( std::function<void( SST::Event* )> handler ) { m_mmioResponse = handler; }
+
   // Use component name for issuing dram requests. Memhierarchy won't recognize the backend as a source or dest.
   void setComponentName( const std::string& name );
 
@@ -74,8 +98,9 @@ public:
 
   // PIM DRAM access
   void handlePIMCompletion( SST::Event* );        // PIM DRAM access done
-  void handleMMIOReadCompletion( SST::Event* );   // Memory controller gets PIM Data to provide in response to network
+  bool handleMMIOReadCompletion( SST::Event* );   // Memory controller gets PIM Data to provide in response to network. False if held.
   void handleMMIOWriteCompletion( SST::Event* );  // Memory controller writes event payload into PIM
+  void holdMMIOResponse( SST::Event* );           // Completed response for a held read. Sent once the PIM is ready.
 
   /* Component API */
   void         setup() override;
@@ -120,6 +145,10 @@ private:
   std::map<ReqId, MemEvent*> outstandingPIMReqs;
 
   std::function<void( SST::Event* )> m_pimRequest;  // called by backend. memory controller's incoming event handler
+  std::function<void( SST::Event* )> m_mmioResponse;  // called by backend. memory controller's response sender
+
+  std::list<MemEvent*> heldMMIOResponses;  // blocking status reads waiting on the PIM
+  void                 releaseMMIOResponses();
 
   bool  initDRAMDone  = false;
   bool  selfCheckDone = false;
@@ -16,6 +16,9 @@ PIMDecoder::PIMDecoder( uint64_t _node ) : node( _node ) {
   nodeOffset=0;
   PIMSegs.emplace_back( std::make_shared<PIMMemSegment>( PIM_ACCESS_TYPE::DRAM, DRAM_BASE, SEG_SIZE ) );
   PIMSegs.emplace_back( std::make_shared<PIMMemSegment>( PIM_ACCESS_TYPE::SRAM, SRAM_BASE + nodeOffset, SEG_SIZE ) );
+  // Control and wait registers sit inside the function window so they must be matched first
+  PIMSegs.emplace_back( std::make_shared<PIMMemSegment>( PIM_ACCESS_TYPE::CTRL, CTRL_BASE + nodeOffset, CTRL_SIZE * sizeof( uint64_t ) ) );
+  PIMSegs.emplace_back( std::make_shared<PIMMemSegment>( PIM_ACCESS_TYPE::WAIT, FUNC_WAIT_BASE + nodeOffset, FUNC_WAIT_SIZE * sizeof( uint64_t ) ) );
   PIMSegs.emplace_back( std::make_shared<PIMMemSegment>( PIM_ACCESS_TYPE::FUNC, FUNC_BASE + nodeOffset, SEG_SIZE ) );
 };
 
@@ -27,7 +30,8 @@ PIMDecodeInfo PIMDecoder::decode( const uint64_t& addr ) {
       break;
     }
   }
-  info.isIO   = ( info.pimAccType == PIM_ACCESS_TYPE::FUNC ) || ( info.pimAccType == PIM_ACCESS_TYPE::SRAM );
+  info.isIO   = ( info.pimAccType == PIM_ACCESS_TYPE::FUNC ) || ( info.pimAccType == PIM_ACCESS_TYPE::SRAM ) ||
+              ( info.pimAccType == PIM_ACCESS_TYPE::CTRL ) || ( info.pimAccType == PIM_ACCESS_TYPE::WAIT );
   info.isDRAM = info.pimAccType == PIM_ACCESS_TYPE::DRAM;
   return info;
 }
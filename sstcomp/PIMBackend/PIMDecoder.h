@@ -22,6 +22,8 @@ enum class PIM_ACCESS_TYPE : unsigned {
   SRAM = 0x2,
   DRAM = 0x3,
   FUNC = 0x10,
+  CTRL = 0x11,
+  WAIT = 0x12,
 };
 
 const std::map<PIM_ACCESS_TYPE, std::string> PIMTYPE2string{
@@ -29,6 +31,8 @@ const std::map<PIM_ACCESS_TYPE, std::string> PIMTYPE2string{
   {PIM_ACCESS_TYPE::SRAM, "SRAM"},
   {PIM_ACCESS_TYPE::DRAM, "DRAM"},
   {PIM_ACCESS_TYPE::FUNC, "FUNC"},
+  {PIM_ACCESS_TYPE::CTRL, "CTRL"},
+  {PIM_ACCESS_TYPE::WAIT, "WAIT"},
 };
 
 enum class PIM_FUNCTION_CONTROL { EVENTS = 0, OPERANDS = 1, EXEC = 2, LOCK = 3 };
@@ -27,6 +27,7 @@ PIMMemController::PIMMemController( ComponentId_t id, Params& params ) : MemCont
   backend->setComponentName( getName() );  // used to generate src identifier for requests
   using std::placeholders::_1;
   backend->setEventInjectionHandler( std::bind( &MemControllerKG::handlePIMEvent, this, _1 ) );
+  backend->setMMIOResponseHandler( std::bind( &MemControllerKG::handleMMIOResponse, this, _1 ) );
 
   // TODO int node_id = params.find<unsigned>( "node_id", -1 );
   // TODO assert( node_id >= 0 );
@@ -44,6 +45,11 @@ void PIMMemController::setup() {
 }
 
 void PIMMemController::handleEvent( SST::Event* event ) {
+  // Custom requests carry no MemEvent address and go straight to the handler
+  if( static_cast<MemEventBase*>( event )->getCmd() == Command::CustomReq ) {
+    MemControllerKG::handleEvent( event );
+    return;
+  }
   MemEvent* ev = static_cast<MemEvent*>( event );
   // If not locally generated PIM DRAM request check for MMIO
   if( !ev->queryFlag( PIMMemEvent::F_PIM ) ) {
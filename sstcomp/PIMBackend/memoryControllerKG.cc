@@ -465,16 +465,8 @@ MemControllerKG::MemControllerKG( ComponentId_t id, Params& params ) : Component
   customCommandHandler_ = loadUserSubComponent<CustomCmdMemHandler>(
     "customCmdHandler",
     ComponentInfo::SHARE_NONE,
-    std::bind(
-      static_cast<void ( MemControllerKG::* )( Addr, size_t, std::vector<uint8_t>& )>( &MemControllerKG::readData ),
-      this,
-      _1,
-      _2,
-      _3
-    ),
-    std::bind(
-      static_cast<void ( MemControllerKG::* )( Addr, std::vector<uint8_t>* )>( &MemControllerKG::writeData ), this, _1, _2
-    )
+    std::bind( &MemControllerKG::readGlobalData, this, _1, _2, _3 ),
+    std::bind( &MemControllerKG::writeGlobalData, this, _1, _2 )
   );
   if( nullptr == customCommandHandler_ ) {
     std::string customHandlerName = params.find<std::string>( "customCmdHandler", "" );
@@ -485,16 +477,8 @@ MemControllerKG::MemControllerKG( ComponentId_t id, Params& params ) : Component
         0,
         ComponentInfo::INSERT_STATS,
         params,
-        std::bind(
-          static_cast<void ( MemControllerKG::* )( Addr, size_t, std::vector<uint8_t>& )>( &MemControllerKG::readData ),
-          this,
-          _1,
-          _2,
-          _3
-        ),
-        std::bind(
-          static_cast<void ( MemControllerKG::* )( Addr, std::vector<uint8_t>* )>( &MemControllerKG::writeData ), this, _1, _2
-        )
+        std::bind( &MemControllerKG::readGlobalData, this, _1, _2, _3 ),
+        std::bind( &MemControllerKG::writeGlobalData, this, _1, _2 )
       );
     }
   }
@@ -517,6 +501,22 @@ void MemControllerKG::handleFLinkEvent( SST::Event* event ) {
   assert( false );
 }
 
+// Held MMIO read response released by the PIM backend
+void MemControllerKG::handleMMIOResponse( SST::Event* event ) {
+  MemEvent* resp = static_cast<MemEvent*>( event );
+  if( is_debug_event( resp ) ) {
+    Debug(
+      _L3_,
+      "E: %-20" PRIu64 " %-20" PRIu64 " %-20s Event:Resp    (%s)\n",
+      getCurrentSimCycle(),
+      getNextClockCycle( clockTimeBase_ ) - 1,
+      getName().c_str(),
+      resp->getVerboseString( dlevel ).c_str()
+    );
+  }
+  link_->send( resp );
+}
+
 void MemControllerKG::handleEvent( SST::Event* event ) {
   if( !clockOn_ ) {
     Cycle_t cycle = turnClockOn();
@@ -824,7 +824,6 @@ void MemControllerKG::handleMemResponse( Event::id_type id, uint32_t flags ) {
 
   /* Handle custom events */
   if( evb->getCmd() == Command::CustomReq ) {
-    assert( false );
     MemEventBase* resp = customCommandHandler_->finish( evb, flags );
     if( resp != nullptr )
       link_->send( resp );
@@ -858,6 +857,7 @@ void MemControllerKG::handleMemResponse( Event::id_type id, uint32_t flags ) {
   MemEvent* resp = ev->makeResponse();
 
   /* Read order matches execute order so that mis-ordering at backend can result in bad data */
+  bool heldMMIO = false;
   if( resp->getCmd() == Command::GetSResp || resp->getCmd() == Command::GetXResp ) {
     if( resp->queryFlag( PIMMemEvent::F_MMIO ) ) {
       resp->clearFlag( PIMMemEvent::F_MMIO );
@@ -866,7 +866,8 @@ void MemControllerKG::handleMemResponse( Event::id_type id, uint32_t flags ) {
         resp->setBaseAddr( translateToGlobal( ev->getBaseAddr() ) );
         resp->setAddr( translateToGlobal( ev->getAddr() ) );
       }
-      static_cast<PIM::PIMBackend*>( memory_ )->handleMMIOReadCompletion( resp );
+      // Blocking status registers hold the response until the PIM is ready
+      heldMMIO = !static_cast<PIM::PIMBackend*>( memory_ )->handleMMIOReadCompletion( resp );
     } else {
       readData( resp );
     }
@@ -894,6 +895,8 @@ void MemControllerKG::handleMemResponse( Event::id_type id, uint32_t flags ) {
 
   if( ev->queryFlag( PIMMemEvent::F_PIM ) ) {
     static_cast<PIM::PIMBackend*>( memory_ )->handlePIMCompletion( resp );
+  } else if( heldMMIO ) {
+    static_cast<PIM::PIMBackend*>( memory_ )->holdMMIOResponse( resp );
   } else {
     link_->send( resp );
   }
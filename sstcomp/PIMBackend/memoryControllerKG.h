@@ -166,6 +166,7 @@ public:
 
   virtual void handlePIMEvent( SST::Event* );
   virtual void handleFLinkEvent( SST::Event* );
+  virtual void handleMMIOResponse( SST::Event* );
 
 protected:
   MemControllerKG();  // for serialization only
@@ -226,6 +227,10 @@ protected:
   Addr translateToLocal( Addr addr );
   Addr translateToGlobal( Addr addr );
 
+  /* Backing store access for the custom command handler, whose payloads carry global addresses */
+  void writeGlobalData( Addr addr, std::vector<uint8_t>* data ) { writeData( translateToLocal( addr ), data ); }
+  void readGlobalData( Addr addr, size_t size, std::vector<uint8_t>& data ) { readData( translateToLocal( addr ), size, data ); }
+
   Clock::Handler<MemControllerKG>* clockHandler_;
   TimeConverter*                   clockTimeBase_;
 
@@ -52,6 +52,8 @@ public:
   virtual bool isMMIO( uint64_t addr )                                 = 0;
   virtual void read( Addr, uint64_t numBytes, std::vector<uint8_t>& )  = 0;
   virtual void write( Addr, uint64_t numBytes, std::vector<uint8_t>* ) = 0;
+  // Blocking registers: MMIO read responses are held until this returns true
+  virtual bool readReady( Addr ) { return true; }
   // DRAM request callback (uint64_t a, MemEventBase::dataVec* d, unsigned bytes, bool isWrite, std::function<void(const uint64_t&)> completion)
   std::function<void( uint64_t, MemEventBase::dataVec*, bool, std::function<void( const MemEventBase::dataVec& )> )>
     m_issueDRAMRequest;
@@ -64,7 +66,6 @@ public:
 
   //TODO protect and friend FSM
   SST::Output*          output;
-  MemEventBase::dataVec buffer;
 
 };  // class PIMifc
 
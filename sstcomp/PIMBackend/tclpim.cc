@@ -11,7 +11,7 @@
 
 namespace SST::PIM {
 
-TCLPIM::TCLPIM( uint64_t node, SST::Output* o ) : PIM( o ) {
+TCLPIM::TCLPIM( uint64_t node, SST::Output* o, SST::Params& params ) : PIM( o ) {
   // simulator defined identifier
   id          = ( uint64_t( PIM_TYPE_TCL ) << 56 ) | ( node << 12 );
   sramArray[0] = id;
@@ -19,11 +19,110 @@ TCLPIM::TCLPIM( uint64_t node, SST::Output* o ) : PIM( o ) {
   // mmio decoder
   pimDecoder = new PIMDecoder( node );
 
+  // FSM tunables
+  config.dmaMaxReads   = params.find<unsigned>( "dma_max_reads", config.dmaMaxReads );
+  config.dmaMaxWrites  = params.find<unsigned>( "dma_max_writes", config.dmaMaxWrites );
+  config.dmaChunkBytes = params.find<unsigned>( "dma_chunk_bytes", config.dmaChunkBytes );
+  config.dmaTileBytes  = params.find<unsigned>( "dma_tile_bytes", config.dmaTileBytes );
+  config.gsBurstBytes     = params.find<unsigned>( "gs_burst_bytes", config.gsBurstBytes );
+  config.gsMaxOutstanding = params.find<unsigned>( "gs_max_outstanding", config.gsMaxOutstanding );
+  config.hashMaxProbes    = params.find<unsigned>( "hash_max_probes", config.hashMaxProbes );
+  config.sortLanes        = params.find<unsigned>( "sort_lanes", config.sortLanes );
+  config.histUpdates      = params.find<unsigned>( "hist_updates", config.histUpdates );
+  config.spmvWindow       = params.find<unsigned>( "spmv_window", config.spmvWindow );
+  config.spmvLanes        = params.find<unsigned>( "spmv_lanes", config.spmvLanes );
+  config.gemvBufferBytes  = params.find<unsigned>( "gemv_buffer_bytes", config.gemvBufferBytes );
+  config.gemvMacs         = params.find<unsigned>( "gemv_macs", config.gemvMacs );
+  config.codecBlockCycles = params.find<unsigned>( "codec_block_cycles", config.codecBlockCycles );
+  config.codecEncodeWords = params.find<unsigned>( "codec_encode_words", config.codecEncodeWords );
+  config.codecDecodeWords = params.find<unsigned>( "codec_decode_words", config.codecDecodeWords );
+  config.slsLanes         = params.find<unsigned>( "sls_lanes", config.slsLanes );
+  config.stencilRows      = params.find<unsigned>( "stencil_rows", config.stencilRows );
+  config.stencilLanes     = params.find<unsigned>( "stencil_lanes", config.stencilLanes );
+  if( config.dmaMaxReads == 0 || config.dmaMaxWrites == 0 )
+    output->fatal( CALL_INFO, -1, "dma_max_reads and dma_max_writes must be at least 1\n" );
+  if( config.dmaChunkBytes == 0 || ( config.dmaChunkBytes % 8 ) != 0 )
+    output->fatal( CALL_INFO, -1, "dma_chunk_bytes must be a non-zero multiple of 8\n" );
+  if( config.gsBurstBytes < 8 || ( config.gsBurstBytes & ( config.gsBurstBytes - 1 ) ) != 0 )
+    output->fatal( CALL_INFO, -1, "gs_burst_bytes must be a power of 2 no smaller than 8\n" );
+  if( config.gsMaxOutstanding == 0 )
+    output->fatal( CALL_INFO, -1, "gs_max_outstanding must be at least 1\n" );
+  if( config.hashMaxProbes == 0 )
+    output->fatal( CALL_INFO, -1, "hash_max_probes must be at least 1\n" );
+  if( config.sortLanes == 0 )
+    output->fatal( CALL_INFO, -1, "sort_lanes must be at least 1\n" );
+  if( config.histUpdates == 0 )
+    output->fatal( CALL_INFO, -1, "hist_updates must be at least 1\n" );
+  if( config.spmvWindow == 0 || config.spmvLanes == 0 )
+    output->fatal( CALL_INFO, -1, "spmv_window and spmv_lanes must be at least 1\n" );
+  if( config.gemvMacs == 0 )
+    output->fatal( CALL_INFO, -1, "gemv_macs must be at least 1\n" );
+  if( config.codecEncodeWords == 0 || config.codecDecodeWords == 0 )
+    output->fatal( CALL_INFO, -1, "codec_encode_words and codec_decode_words must be at least 1\n" );
+  if( config.slsLanes == 0 )
+    output->fatal( CALL_INFO, -1, "sls_lanes must be at least 1\n" );
+  if( config.stencilRows < 3 || config.stencilLanes == 0 )
+    output->fatal( CALL_INFO, -1, "stencil_rows must be at least 3 and stencil_lanes at least 1\n" );
+  output->verbose( CALL_INFO, 1, 0, "DMA config: max_reads=%u max_writes=%u chunk_bytes=%u tile_bytes=%u\n",
+    config.dmaMaxReads, config.dmaMaxWrites, config.dmaChunkBytes, config.dmaTileBytes );
+  output->verbose( CALL_INFO, 1, 0, "Gather/scatter config: burst_bytes=%u max_outstanding=%u\n",
+    config.gsBurstBytes, config.gsMaxOutstanding );
+
   // PIM FSM Assignments
   // Built-in function 1: MemCopy
   funcState[FUNC_NUM::F1] = std::make_unique<FuncState>(this, FUNC_NUM::F1, std::make_unique<MemCopy>(this));
+  // Built-in function 2: MemSet
+  funcState[FUNC_NUM::F2] = std::make_unique<FuncState>(this, FUNC_NUM::F2, std::make_unique<MemSet>(this));
+  // Built-in function 3: MemCompare
+  funcState[FUNC_NUM::F3] = std::make_unique<FuncState>(this, FUNC_NUM::F3, std::make_unique<MemCompare>(this));
+  // Built-in function 4: MemSearch
+  funcState[FUNC_NUM::F4] = std::make_unique<FuncState>(this, FUNC_NUM::F4, std::make_unique<MemSearch>(this));
+  // Built-in function 5: 2-D DMA
+  funcState[FUNC_NUM::F5] = std::make_unique<FuncState>(this, FUNC_NUM::F5, std::make_unique<Copy2D>(this));
+  // Built-in function 6: Gather
+  funcState[FUNC_NUM::F6] = std::make_unique<FuncState>(this, FUNC_NUM::F6, std::make_unique<IndexedAccess>(this, false));
+  // Built-in function 7: Scatter
+  funcState[FUNC_NUM::F7] = std::make_unique<FuncState>(this, FUNC_NUM::F7, std::make_unique<IndexedAccess>(this, true));
+  // User function 0: ElementWise
+  funcState[FUNC_NUM::U0] = std::make_unique<FuncState>(this, FUNC_NUM::U0, std::make_unique<ElementWise>(this));
+  // User function 1: Reduce
+  funcState[FUNC_NUM::U1] = std::make_unique<FuncState>(this, FUNC_NUM::U1, std::make_unique<Reduce>(this));
+  // User function 2: Scan
+  funcState[FUNC_NUM::U2] = std::make_unique<FuncState>(this, FUNC_NUM::U2, std::make_unique<Scan>(this));
+  // User function 3: PointerChase
+  funcState[FUNC_NUM::U3] = std::make_unique<FuncState>(this, FUNC_NUM::U3, std::make_unique<PointerChase>(this));
+  // User function 4: HashProbe
+  funcState[FUNC_NUM::U4] = std::make_unique<FuncState>(this, FUNC_NUM::U4, std::make_unique<HashProbe>(this));
   // User function 5: MulVectByScalar
   funcState[FUNC_NUM::U5] = std::make_unique<FuncState>(this, FUNC_NUM::U5, std::make_unique<MulVecByScalar>(this));
+  // User function 6: Sort
+  funcState[FUNC_NUM::U6] = std::make_unique<FuncState>(this, FUNC_NUM::U6, std::make_unique<Sort>(this));
+  // User function 7: Filter
+  funcState[FUNC_NUM::U7] = std::make_unique<FuncState>(this, FUNC_NUM::U7, std::make_unique<Filter>(this));
+  // User function 8: Histogram
+  funcState[FUNC_NUM::U8] = std::make_unique<FuncState>(this, FUNC_NUM::U8, std::make_unique<Histogram>(this));
+  // User function 9: SpMV
+  funcState[FUNC_NUM::U9] = std::make_unique<FuncState>(this, FUNC_NUM::U9, std::make_unique<SpMV>(this));
+  // User function 10: GEMV
+  funcState[FUNC_NUM::U10] = std::make_unique<FuncState>(this, FUNC_NUM::U10, std::make_unique<Gemv>(this));
+  // User function 11: Compress
+  funcState[FUNC_NUM::U11] = std::make_unique<FuncState>(this, FUNC_NUM::U11, std::make_unique<Codec>(this, false));
+  // User function 12: Decompress
+  funcState[FUNC_NUM::U12] = std::make_unique<FuncState>(this, FUNC_NUM::U12, std::make_unique<Codec>(this, true));
+  // User function 13: Sparse lengths sum
+  funcState[FUNC_NUM::U13] = std::make_unique<FuncState>(this, FUNC_NUM::U13, std::make_unique<SLS>(this));
+  // User function 14: Frontier expansion
+  funcState[FUNC_NUM::U14] = std::make_unique<FuncState>(this, FUNC_NUM::U14, std::make_unique<Frontier>(this));
+  // User function 15: Bitmap operations
+  funcState[FUNC_NUM::U15] = std::make_unique<FuncState>(this, FUNC_NUM::U15, std::make_unique<Bitmap>(this));
+  // User function 16: Checksum
+  funcState[FUNC_NUM::U16] = std::make_unique<FuncState>(this, FUNC_NUM::U16, std::make_unique<Checksum>(this));
+  // User function 17: Stencil
+  funcState[FUNC_NUM::U17] = std::make_unique<FuncState>(this, FUNC_NUM::U17, std::make_unique<Stencil>(this));
+  // User function 18: Bloom filter build
+  funcState[FUNC_NUM::U18] = std::make_unique<FuncState>(this, FUNC_NUM::U18, std::make_unique<Bloom>(this, false));
+  // User function 19: Bloom filter probe
+  funcState[FUNC_NUM::U19] = std::make_unique<FuncState>(this, FUNC_NUM::U19, std::make_unique<Bloom>(this, true));
 
 }
 
@@ -34,16 +133,26 @@ TCLPIM::~TCLPIM() {
 
 bool TCLPIM::clock( SST::Cycle_t cycle ) {
   this->cycle = cycle;
-  for (auto func : funcState ) {
-    if (func.second->running()) {
-      uint64_t done = func.second->exec()->clock();
-      if (done) {
-        func.second->writeFSM(FUNC_CMD::FINISH);
-        return true;
-      }
-    }
+  // Advance every running function each cycle
+  for (auto& func : funcState ) {
+    if (!func.second->running())
+      continue;
+    bool done = func.second->exec()->clock();
+    if (done)
+      func.second->writeFSM(FUNC_CMD::FINISH);
   }
-  return false;
+  // Launch queued descriptors in the same cycle their inputs complete
+  bool idle = true;
+  if( fetchDescriptors() )
+    idle = false;
+  if( dispatchLaunches() )
+    idle = false;
+  // PIM may be unclocked once nothing is left running, including functions
+  // launched this cycle
+  for (auto& func : funcState )
+    if (func.second->running())
+      idle = false;
+  return idle;
 }
 
 uint64_t TCLPIM::getCycle() {
@@ -63,20 +172,172 @@ PIMDecodeInfo TCLPIM::getDecodeInfo(uint64_t addr)
 
 uint64_t TCLPIM::decodeFuncNum(uint64_t a, unsigned numBytes)
 {
-    // 16 functions
-    unsigned n = ( a >> 3 ) & 0xf;
+    // 32 functions
+    unsigned n = ( a >> 3 ) & 0x1f;
     assert(n < SST::PIM::FUNC_SIZE );
     assert( (a & 0x7UL) == 0 ); // byte aligned
     assert( numBytes == 8 );
     return n;
 }
 
+unsigned TCLPIM::decodeCtrlReg( uint64_t a, unsigned numBytes ) {
+  unsigned n = ( a - CTRL_BASE ) >> 3;
+  assert( n < SST::PIM::CTRL_SIZE );
+  assert( ( a & 0x7UL ) == 0 );  // byte aligned
+  assert( numBytes == 8 );
+  return n;
+}
+
+void TCLPIM::ctrl_write( CTRL_REG reg, uint64_t data ) {
+  switch( reg ) {
+  case CTRL_REG::RING_BASE:
+    // zero disables the ring (also tolerates loader initialization of the register block)
+    if( data == 0 ) {
+      ringBase = ringSize = ringHead = ringTail = 0;
+      break;
+    }
+    if( pimDecoder->decode( data ).pimAccType != PIM_ACCESS_TYPE::SRAM )
+      output->fatal( CALL_INFO, -1, "Descriptor ring base 0x%" PRIx64 " must be an SRAM address\n", data );
+    ringBase = ( data % SRAM_SIZE ) >> 3;
+    ringHead = ringTail = 0;
+    break;
+  case CTRL_REG::RING_SIZE:
+    ringSize = data;
+    ringHead = ringTail = 0;
+    break;
+  case CTRL_REG::RING_HEAD:
+    if( data != 0 && data >= ringSize )
+      output->fatal( CALL_INFO, -1, "Descriptor ring head %" PRId64 " out of range (size %" PRId64 ")\n", data, ringSize );
+    ringHead = data;
+    break;
+  default:
+    output->verbose( CALL_INFO, 1, 0, "Warning: Ignoring write to read-only control register %d\n", static_cast<int>( reg ) );
+    break;
+  }
+  if( ringBase + ringSize > SRAM_SIZE / sizeof( uint64_t ) )
+    output->fatal( CALL_INFO, -1, "Descriptor ring exceeds SRAM (base=%" PRId64 " size=%" PRId64 ")\n", ringBase, ringSize );
+}
+
+uint64_t TCLPIM::ctrl_read( CTRL_REG reg ) {
+  switch( reg ) {
+  case CTRL_REG::RING_BASE: return SRAM_BASE + ringBase * sizeof( uint64_t );
+  case CTRL_REG::RING_SIZE: return ringSize;
+  case CTRL_REG::RING_HEAD: return ringHead;
+  case CTRL_REG::RING_TAIL:
+  case CTRL_REG::RING_WAIT: return ringTail;
+  default: return 0;
+  }
+}
+
+bool TCLPIM::readReady( Addr addr ) {
+  PIMDecodeInfo info = pimDecoder->decode( addr );
+  if( info.pimAccType == PIM_ACCESS_TYPE::WAIT ) {
+    auto it = funcState.find( static_cast<FUNC_NUM>( decodeFuncNum( addr, sizeof( uint64_t ) ) ) );
+    return it == funcState.end() || !it->second->busy();
+  }
+  if( info.pimAccType == PIM_ACCESS_TYPE::CTRL &&
+      static_cast<CTRL_REG>( decodeCtrlReg( addr, sizeof( uint64_t ) ) ) == CTRL_REG::RING_WAIT ) {
+    if( ringTail != ringHead || !pendingLaunches.empty() )
+      return false;
+    for( auto& func : funcState )
+      if( func.second->running() )
+        return false;
+  }
+  return true;
+}
+
+uint64_t TCLPIM::ringWord( uint64_t index ) {
+  return sramArray[ringBase + ( index % ringSize )];
+}
+
+// Move descriptors from the SRAM ring into the launch window. Consumed
+// ring space is released to the host immediately.
+// Returns true while descriptors remain in the ring.
+bool TCLPIM::fetchDescriptors() {
+  while( ringTail != ringHead && pendingLaunches.size() < MAX_PENDING_LAUNCHES ) {
+    assert( ringSize > 0 );
+    uint64_t hdr   = ringWord( ringTail );
+    unsigned fnum  = ( hdr >> DESC_FNUM_SHIFT ) & 0xff;
+    unsigned nargs = ( hdr >> DESC_NARGS_SHIFT ) & 0xff;
+    unsigned cpl   = ( hdr >> DESC_CPL_SHIFT ) & 0xffff;
+    bool     deps  = ( hdr & DESC_DEPS_FLAG ) != 0;
+    if( nargs > NUM_FUNC_PARAMS || cpl >= SRAM_SIZE / sizeof( uint64_t ) )
+      output->fatal( CALL_INFO, -1, "Bad descriptor 0x%" PRIx64 " at ring index %" PRId64 "\n", hdr, ringTail );
+    if( funcState.find( static_cast<FUNC_NUM>( fnum ) ) == funcState.end() )
+      output->fatal( CALL_INFO, -1, "Descriptor for unassigned function %u\n", fnum );
+
+    Launch l   = {};
+    l.seq      = nextLaunchSeq++;
+    l.fnum     = static_cast<FUNC_NUM>( fnum );
+    l.nargs    = nargs;
+    l.cpl      = cpl;
+    uint64_t w = ringTail + 1;
+    if( deps ) {
+      // bit i: wait for the descriptor i+1 positions earlier
+      uint64_t mask = ringWord( w++ );
+      for( unsigned i = 0; i < 64; i++ )
+        if( ( ( mask >> i ) & 1 ) && l.seq > i )
+          l.deps.push_back( l.seq - i - 1 );
+    }
+    for( unsigned i = 0; i < nargs; i++ )
+      l.params[i] = ringWord( w++ );
+    output->verbose(
+      CALL_INFO, 3, 0, "PIM 0x%" PRIx64 " RING fetch seq=%" PRId64 " FUNC[%u] tail=%" PRId64 " deps=%zu\n",
+      id, l.seq, fnum, ringTail, l.deps.size()
+    );
+    pendingLaunches.push_back( l );
+    incompleteLaunches.insert( l.seq );
+    ringTail = w % ringSize;
+  }
+  return ringTail != ringHead;
+}
+
+// Start every window entry whose dependencies are complete and whose function
+// slot is free. Entries for the same slot start in ring order.
+// Returns true if anything launched this cycle or launches remain pending.
+bool TCLPIM::dispatchLaunches() {
+  std::set<FUNC_NUM> blocked;
+  bool               launched = false;
+  for( auto it = pendingLaunches.begin(); it != pendingLaunches.end(); ) {
+    bool ready = blocked.count( it->fnum ) == 0 && !funcState[it->fnum]->busy();
+    for( uint64_t d : it->deps )
+      ready = ready && incompleteLaunches.count( d ) == 0;
+    if( !ready ) {
+      blocked.insert( it->fnum );
+      ++it;
+      continue;
+    }
+    output->verbose(
+      CALL_INFO, 3, 0, "PIM 0x%" PRIx64 " RING launch seq=%" PRId64 " FUNC[%d]\n", id, it->seq, static_cast<int>( it->fnum )
+    );
+    funcState[it->fnum]->launch( it->params, it->nargs, it->cpl, it->seq );
+    blocked.insert( it->fnum );
+    it       = pendingLaunches.erase( it );
+    launched = true;
+  }
+  return launched || !pendingLaunches.empty();
+}
+
+void TCLPIM::completeLaunch( uint64_t seq ) {
+  incompleteLaunches.erase( seq );
+}
+
 void TCLPIM::read( Addr addr, uint64_t numBytes, std::vector<uint8_t>& payload ) {
   PIMDecodeInfo info = pimDecoder->decode( addr );
-  if( info.pimAccType == PIM_ACCESS_TYPE::SRAM ) {
+  if( info.pimAccType == PIM_ACCESS_TYPE::CTRL ) {
+    uint64_t d = ctrl_read( static_cast<CTRL_REG>( decodeCtrlReg( addr, numBytes ) ) );
+    uint8_t* p = (uint8_t*) ( &d );
+    for( unsigned i = 0; i < numBytes; i++ ) {
+      payload[i] = p[i];
+    }
+    output->verbose(
+      CALL_INFO, 3, 0, "PIM 0x%" PRIx64 " IO READ CTRL A=0x%" PRIx64 " D=0x%" PRIx64 "\n", id, addr, d
+    );
+  } else if( info.pimAccType == PIM_ACCESS_TYPE::SRAM ) {
     unsigned spdIndex = ( addr % SRAM_SIZE ) >> 3;
     unsigned byte     = ( addr & 0x7 );
-    assert(spdIndex < sizeof(sramArray)/sizeof(uint64_t));
+    if( ( addr % SRAM_SIZE ) + numBytes > SRAM_SIZE )
+      output->fatal( CALL_INFO, -1, "SRAM read A=0x%" PRIx64 " BYTES=%" PRId64 " out of range\n", addr, numBytes );
     uint8_t* p = (uint8_t*) ( &( sramArray[spdIndex] ) );
     for( unsigned i = 0; i < numBytes; i++ ) {
       payload[i] = p[byte + i];
@@ -85,6 +346,7 @@ void TCLPIM::read( Addr addr, uint64_t numBytes, std::vector<uint8_t>& payload )
       CALL_INFO, 3, 0, "PIM 0x%" PRIx64 " IO READ SRAM A=0x%" PRIx64 " D=0x%" PRIx64 "\n", id, addr, sramArray[spdIndex]
     );
   } else {
+    // FUNC or WAIT window. WAIT responses were held until readReady().
     unsigned fnum = decodeFuncNum(addr, numBytes);
     output->verbose( CALL_INFO, 3, 0, "PIM 0x%" PRIx64 " IO READ FUNC[%d]\n", id, fnum );
     uint64_t d = funcState[static_cast<FUNC_NUM>(fnum)]->readFSM();
@@ -107,7 +369,8 @@ void TCLPIM::write( Addr addr, uint64_t numBytes, std::vector<uint8_t>* payload
       // Eight 8-byte entries. Byte Addressable (memcpy -O0 does byte copy).
     unsigned offset = ( addr % SRAM_SIZE ) >> 3;
     unsigned byte   = ( addr & 0x7 );
-    assert(offset<sizeof(sramArray)/sizeof(uint64_t));
+    if( ( addr % SRAM_SIZE ) + numBytes > SRAM_SIZE )
+      output->fatal( CALL_INFO, -1, "SRAM write A=0x%" PRIx64 " BYTES=%" PRId64 " out of range\n", addr, numBytes );
     uint8_t* p = (uint8_t*) ( &( sramArray[offset] ) );
     for( unsigned i = 0; i < numBytes; i++ ) {
       p[byte + i] = payload->at( i );
@@ -125,6 +388,16 @@ void TCLPIM::write( Addr addr, uint64_t numBytes, std::vector<uint8_t>* payload
 
     output->verbose( CALL_INFO, 3, 0, "PIM 0x%" PRIx64 " IO WRITE FUNC[%d] D=0x%" PRIx64 "\n", id, fnum, data );
     funcState[static_cast<FUNC_NUM>(fnum)]->writeFSM(data);
+  } else if( info.pimAccType == PIM_ACCESS_TYPE::CTRL ) {
+    unsigned reg  = decodeCtrlReg( addr, numBytes );
+    uint64_t data = 0;
+    uint8_t* p = (uint8_t*) ( &data );
+    for( unsigned i = 0; i < numBytes; i++ )
+      p[i] = payload->at( i );
+    output->verbose( CALL_INFO, 3, 0, "PIM 0x%" PRIx64 " IO WRITE CTRL[%d] D=0x%" PRIx64 "\n", id, reg, data );
+    ctrl_write( static_cast<CTRL_REG>( reg ), data );
+  } else if( info.pimAccType == PIM_ACCESS_TYPE::WAIT ) {
+    output->verbose( CALL_INFO, 1, 0, "Warning: Ignoring write to function wait register A=0x%" PRIx64 "\n", addr );
   } else {
     assert( false );
   }
@@ -171,6 +444,14 @@ void TCLPIM::FuncState::writeFSM(uint64_t d)
         fstate = FSTATE::DONE;
         counter = 0;
         parent->output->verbose( CALL_INFO, 3, 0, "Function[%" PRId32 "] Done\n", static_cast<int>(fnum) );
+        if (cplSlot) {
+          parent->sramArray[cplSlot] = static_cast<uint64_t>(FSTATE::DONE);
+          cplSlot = 0;
+        }
+        if (launchSeq >= 0) {
+          parent->completeLaunch(launchSeq);
+          launchSeq = -1;
+        }
       break;
   }
 }
@@ -190,6 +471,25 @@ bool TCLPIM::FuncState::running()
     return fstate==FSTATE::RUNNING;
 }
 
+bool TCLPIM::FuncState::busy()
+{
+    // host MMIO launch in progress or function executing
+    return fstate==FSTATE::INITIALIZING || fstate==FSTATE::READY || fstate==FSTATE::RUNNING;
+}
+
+// Descriptor launch: equivalent to INIT, nargs params and RUN in one step
+void TCLPIM::FuncState::launch(const uint64_t* p, unsigned nargs, unsigned cpl, int64_t seq)
+{
+  assert(!busy());
+  assert(nargs <= NUM_FUNC_PARAMS);
+  writeFSM(FUNC_CMD::INIT);
+  for (unsigned i = 0; i < NUM_FUNC_PARAMS; i++)
+    writeFSM(i < nargs ? p[i] : 0);
+  cplSlot = cpl;
+  launchSeq = seq;
+  writeFSM(FUNC_CMD::RUN);
+}
+
 std::shared_ptr<FSM> TCLPIM::FuncState::exec()
 {
     assert(exec_);
@@ -8,24 +8,53 @@
 #ifndef _SST_PIMBACKEND_TCLPIM_
 #define _SST_PIMBACKEND_TCLPIM_
 
+#include <deque>
+#include <map>
+#include <set>
+
 #include "pim.h"
 
 namespace SST::PIM {
 
 class FSM;
 
+// Tunables shared by the function FSMs. Set from PIMBackend parameters.
+struct TCLPIMConfig {
+  unsigned dmaMaxReads   = 4;    // in-flight DRAM read chunks per DMA engine
+  unsigned dmaMaxWrites  = 4;    // in-flight DRAM write chunks per DMA engine
+  unsigned dmaChunkBytes = 512;  // bytes moved per DRAM request
+  unsigned dmaTileBytes  = 4096;  // transpose staging limit for 2-D DMA
+  unsigned gsBurstBytes     = 64;  // gather/scatter coalescing granule
+  unsigned gsMaxOutstanding = 16;  // in-flight gather/scatter element requests
+  unsigned hashMaxProbes    = 16;  // hash table probes in flight
+  unsigned sortLanes        = 8;   // sort compare-exchange units, records merged per cycle
+  unsigned histUpdates      = 4;   // histogram bin updates per cycle
+  unsigned spmvWindow       = 64;  // SpMV nonzeros waiting on x
+  unsigned spmvLanes        = 2;   // SpMV nonzeros admitted and retired per cycle
+  unsigned gemvBufferBytes  = 1024;  // GEMV weight bytes per ping-pong buffer
+  unsigned gemvMacs         = 16;    // GEMV multiply-accumulates per cycle
+  unsigned codecBlockCycles = 2;     // codec setup cycles per block
+  unsigned codecEncodeWords = 4;     // words compressed per cycle
+  unsigned codecDecodeWords = 8;     // words decompressed per cycle
+  unsigned slsLanes         = 16;    // SLS row elements pooled per cycle
+  unsigned stencilRows      = 6;     // stencil SRAM ring depth in rows
+  unsigned stencilLanes     = 8;     // stencil outputs computed per cycle
+};
+
 class TCLPIM : public PIM {
 public:
-  TCLPIM( uint64_t node, SST::Output* o );
+  TCLPIM( uint64_t node, SST::Output* o, SST::Params& params );
   virtual ~TCLPIM();
   void     setup() override {};
   bool     clock( SST::Cycle_t ) override;
   uint64_t getCycle() override;
   bool     isMMIO( uint64_t addr ) override;
   PIMDecodeInfo  getDecodeInfo( uint64_t addr);
+  const TCLPIMConfig& getConfig() { return config; }
   // IO access functions
   void read( Addr, uint64_t numBytes, std::vector<uint8_t>& ) override;
   void write( Addr, uint64_t numBytes, std::vector<uint8_t>* ) override;
+  bool readReady( Addr ) override;
 
   // Primary functional state machine
   class FuncState {
@@ -36,6 +65,8 @@ public:
     void writeFSM(uint64_t d);
     uint64_t readFSM();
     bool running();
+    bool busy();
+    void launch( const uint64_t* p, unsigned nargs, unsigned cplSlot, int64_t seq );
     std::shared_ptr<FSM> exec();
     
   private:
@@ -46,6 +77,8 @@ public:
     FSTATE fstate = FSTATE::INVALID;
     // TODO bool lock = false;
     int counter = 0;
+    unsigned cplSlot = 0;  // SRAM dword written on completion (0 for none)
+    int64_t launchSeq = -1;  // descriptor sequence number (-1 for MMIO launches)
 
   }; // class FuncState
 
@@ -53,6 +86,7 @@ private:
   uint64_t   id;
   PIMDecoder* pimDecoder;
   uint64_t   cycle = 0;
+  TCLPIMConfig config;
 
   // memory mapped IO
   std::vector<std::shared_ptr<PIMMemSegment>> PIMSegs;
@@ -62,6 +96,34 @@ private:
   uint64_t             decodeFuncNum( uint64_t address, unsigned numBytes );
   std::map< FUNC_NUM, shared_ptr<FuncState>> funcState;
 
+  // descriptor ring in SRAM (indices in dwords)
+  uint64_t ringBase = 0;
+  uint64_t ringSize = 0;
+  uint64_t ringHead = 0;
+  uint64_t ringTail = 0;
+  unsigned decodeCtrlReg( uint64_t address, unsigned numBytes );
+  void     ctrl_write( CTRL_REG reg, uint64_t data );
+  uint64_t ctrl_read( CTRL_REG reg );
+  uint64_t ringWord( uint64_t index );
+
+  // Launch window: descriptors fetched from the ring waiting on their
+  // dependencies or their function slot. Dependencies resolve on the PIM.
+  static const unsigned MAX_PENDING_LAUNCHES = 64;
+  struct Launch {
+    uint64_t              seq;
+    FUNC_NUM              fnum;
+    unsigned              nargs;
+    unsigned              cpl;
+    uint64_t              params[NUM_FUNC_PARAMS];
+    std::vector<uint64_t> deps;  // sequence numbers that must complete first
+  };
+  std::deque<Launch> pendingLaunches;
+  std::set<uint64_t> incompleteLaunches;  // fetched but not finished
+  uint64_t           nextLaunchSeq = 0;
+  bool               fetchDescriptors();
+  bool               dispatchLaunches();
+  void               completeLaunch( uint64_t seq );
+
 };  //class TCLPIM
 
 class FSM {
@@ -73,6 +135,8 @@ public:
 
 protected:
   TCLPIM* parent;
+  // Private staging storage so concurrently running functions never share data
+  MemEventBase::dataVec buffer;
 }; //class FSM
 
 } // namespace SST::PIM
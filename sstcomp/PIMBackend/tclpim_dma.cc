@@ -0,0 +1,236 @@
+//
+// Copyright (C) 2017-2024 Tactical Computing Laboratories, LLC
+// All Rights Reserved
+// contact@tactcomplabs.com
+// See LICENSE in the top level directory for licensing details
+//
+
+#include <cstring>
+
+#include "tclpim_dma.h"
+
+namespace SST::PIM {
+
+DMAEngine::DMAEngine( TCLPIM* p ) : parent( p ) {
+  const TCLPIMConfig& cfg = parent->getConfig();
+  // Every chunk is either reading, waiting to be written, or writing.
+  chunks.resize( cfg.dmaMaxReads + cfg.dmaMaxWrites );
+}
+
+void DMAEngine::start( uint64_t dst, uint64_t src, uint64_t numBytes ) {
+  start( dst, std::vector<uint64_t>{ src }, numBytes, nullptr );
+}
+
+void DMAEngine::start(
+  uint64_t dst, const std::vector<uint64_t>& srcs, uint64_t numBytes, Transform xform, bool inOrder
+) {
+  Segment seg;
+  seg.dst   = dst;
+  seg.srcs  = srcs;
+  seg.bytes = numBytes;
+  start( std::vector<Segment>{ seg }, xform, inOrder );
+}
+
+void DMAEngine::start( const std::vector<Segment>& segs, Transform xform, bool inOrder ) {
+  assert( !active );
+  this->segs     = segs;
+  this->xform    = xform;
+  this->inOrder  = inOrder;
+  segIdx         = 0;
+  segOff         = 0;
+  remaining      = 0;
+  nextSeq        = 0;
+  nextOut        = 0;
+  readsInFlight  = 0;
+  writesInFlight = 0;
+
+  // TODO check for overlapping ranges
+  size_t numSrcs = 1;
+  for( auto& seg : this->segs ) {
+    if( seg.local )
+      seg.srcs.assign( 1, 0 );
+    assert( seg.srcs.size() >= 1 && seg.srcs.size() <= MAX_SOURCES );
+    numSrcs = std::max( numSrcs, seg.srcs.size() );
+    remaining += seg.bytes;
+    if( seg.dst != NO_DST )
+      isSRAM( seg.dst, "Destination" );
+    if( !seg.local )
+      for( uint64_t src : seg.srcs )
+        isSRAM( src, "Source" );
+  }
+  for( auto& c : chunks )
+    c.buffers.resize( numSrcs );
+  active = remaining > 0;
+}
+
+void DMAEngine::stop() {
+  remaining = 0;
+}
+
+bool DMAEngine::isSRAM( uint64_t addr, const char* what ) {
+  auto inf = parent->getDecodeInfo( addr );
+  if( inf.isIO && ( inf.pimAccType != PIM_ACCESS_TYPE::SRAM ) )
+    parent->output->fatal( CALL_INFO, -1, "%s address must by SRAM or DRAM\n", what );
+  return inf.isIO;
+}
+
+bool DMAEngine::clock() {
+  if( !active )
+    return true;
+
+  // One read and one write may issue per cycle so the two directions overlap.
+  issueWrite();
+  issueRead();
+
+  if( remaining == 0 && readsInFlight == 0 && writesInFlight == 0 ) {
+    for( auto& c : chunks )
+      if( c.state != CHUNK_STATE::FREE )
+        return false;
+    active = false;
+    return true;
+  }
+  return false;
+}
+
+void DMAEngine::issueRead() {
+  if( remaining == 0 || readsInFlight >= parent->getConfig().dmaMaxReads )
+    return;
+  int idx = freeChunk();
+  if( idx < 0 )
+    return;
+
+  while( segs[segIdx].bytes == segOff ) {
+    segIdx++;
+    segOff = 0;
+  }
+  const Segment& seg   = segs[segIdx];
+  Chunk&         c     = chunks[idx];
+  uint64_t       bytes = std::min<uint64_t>( seg.bytes - segOff, parent->getConfig().dmaChunkBytes );
+  c.seq                = nextSeq++;
+  c.dst                = seg.dst == NO_DST ? NO_DST : seg.dst + segOff;
+  c.state              = CHUNK_STATE::READING;
+  c.readsPending       = seg.srcs.size();
+  readsInFlight++;
+
+  for( size_t i = 0; i < seg.srcs.size(); i++ ) {
+    uint64_t src = seg.srcs[i] + segOff;
+    c.buffers[i].resize( bytes );
+    if( seg.local ) {
+      std::memcpy( c.buffers[i].data(), seg.local + segOff, bytes );
+      c.readsPending--;
+    } else if( isSRAM( src, "Source" ) ) {
+      parent->read( src, bytes, c.buffers[i] );
+      c.readsPending--;
+    } else {
+      uint64_t seq = c.seq;
+      parent->m_issueDRAMRequest( src, &c.buffers[i], false, [this, idx, i, seq]( const MemEventBase::dataVec& d ) {
+        Chunk& rc = chunks[idx];
+        assert( rc.state == CHUNK_STATE::READING && rc.seq == seq && rc.readsPending > 0 );
+        assert( rc.buffers[i].size() == d.size() );
+        rc.buffers[i] = d;
+        rc.readsPending--;
+        if( rc.readsPending == 0 )
+          readDone( rc );
+      } );
+    }
+    parent->output->verbose(
+      CALL_INFO, 4, 0, "dma read seq=%" PRId64 " src=0x%" PRIx64 " bytes=%" PRId64 "\n", c.seq, src, bytes
+    );
+  }
+  if( c.readsPending == 0 )
+    readDone( c );
+  segOff += bytes;
+  remaining -= bytes;
+}
+
+// All sources of a chunk are staged
+void DMAEngine::readDone( Chunk& c ) {
+  if( xform && !inOrder )
+    xform( c.buffers );
+  c.state = CHUNK_STATE::READY;
+  readsInFlight--;
+}
+
+void DMAEngine::issueWrite() {
+  if( writesInFlight >= parent->getConfig().dmaMaxWrites )
+    return;
+  int idx = oldestReadyChunk();
+  if( idx < 0 )
+    return;
+
+  Chunk& c = chunks[idx];
+  if( inOrder ) {
+    if( c.seq != nextOut )
+      return;
+    nextOut++;
+    if( xform )
+      xform( c.buffers );
+  }
+  if( c.dst == NO_DST ) {
+    c.state = CHUNK_STATE::FREE;
+    return;
+  }
+  parent->output->verbose(
+    CALL_INFO, 4, 0, "dma write seq=%" PRId64 " dst=0x%" PRIx64 " bytes=%zu\n", c.seq, c.dst, c.buffers[0].size()
+  );
+  if( isSRAM( c.dst, "Destination" ) ) {
+    parent->write( c.dst, c.buffers[0].size(), &c.buffers[0] );
+    c.state = CHUNK_STATE::FREE;
+  } else {
+    c.state = CHUNK_STATE::WRITING;
+    writesInFlight++;
+    uint64_t seq = c.seq;
+    parent->m_issueDRAMRequest( c.dst, &c.buffers[0], true, [this, idx, seq]( const MemEventBase::dataVec& d ) {
+      Chunk& wc = chunks[idx];
+      assert( wc.state == CHUNK_STATE::WRITING && wc.seq == seq );
+      wc.state = CHUNK_STATE::FREE;
+      writesInFlight--;
+    } );
+  }
+}
+
+int DMAEngine::freeChunk() {
+  for( size_t i = 0; i < chunks.size(); i++ )
+    if( chunks[i].state == CHUNK_STATE::FREE )
+      return i;
+  return -1;
+}
+
+int DMAEngine::oldestReadyChunk() {
+  int idx = -1;
+  for( size_t i = 0; i < chunks.size(); i++ ) {
+    if( chunks[i].state != CHUNK_STATE::READY )
+      continue;
+    if( idx < 0 || chunks[i].seq < chunks[idx].seq )
+      idx = i;
+  }
+  return idx;
+}
+
+OutStream::OutStream( TCLPIM* p ) : parent( p ) {}
+
+void OutStream::start( uint64_t addr, uint64_t chunkBytes ) {
+  assert( out.empty() );
+  base  = addr;
+  next  = addr;
+  chunk = chunkBytes ? chunkBytes : parent->getConfig().dmaChunkBytes;
+}
+
+void OutStream::flush( bool last, unsigned otherWrites ) {
+  if( out.empty() || writesInFlight + otherWrites >= parent->getConfig().dmaMaxWrites || ( out.size() < chunk && !last ) )
+    return;
+  uint64_t              n = std::min<uint64_t>( out.size(), chunk );
+  MemEventBase::dataVec w( out.begin(), out.begin() + n );
+  if( parent->getDecodeInfo( next ).isIO ) {
+    parent->write( next, n, &w );
+  } else {
+    writesInFlight++;
+    parent->m_issueDRAMRequest( next, &w, true, [this]( const MemEventBase::dataVec& ) { writesInFlight--; } );
+  }
+  next += n;
+  out.erase( out.begin(), out.begin() + n );
+}
+
+}  // namespace SST::PIM
+
+// EOF
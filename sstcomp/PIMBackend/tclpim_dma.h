@@ -0,0 +1,128 @@
+//
+// Copyright (C) 2017-2024 Tactical Computing Laboratories, LLC
+// All Rights Reserved
+// contact@tactcomplabs.com
+// See LICENSE in the top level directory for licensing details
+//
+
+#ifndef _SST_PIMBACKEND_TCL_PIM_DMA_
+#define _SST_PIMBACKEND_TCL_PIM_DMA_
+
+#include <cstring>
+#include <functional>
+
+#include "tclpim.h"
+
+namespace SST::PIM {
+
+// Pipelined DMA engine used by the function FSMs.
+//
+// A transfer is split into chunks of dmaChunkBytes. Each chunk owns its
+// staging buffer and carries a sequence tag. Up to dmaMaxReads chunk reads
+// and dmaMaxWrites chunk writes are in flight at once, so reads of later
+// chunks overlap writes of earlier ones. SRAM endpoints complete in the
+// issuing cycle.
+//
+// A transfer is a list of segments and chunks never cross a segment, so
+// strided and 2-D copies run as one pipelined transfer. A segment may read
+// up to MAX_SOURCES equally sized streams, or a FSM-local buffer. Once every
+// source of a chunk has landed the optional transform runs on the staged
+// buffers and buffer 0 is written to the destination. With inOrder set the
+// transform sees chunks strictly in segment order, for carried state such as
+// reductions and scans. A NO_DST segment only feeds the transform.
+class DMAEngine {
+public:
+  static const unsigned MAX_SOURCES = 4;
+  static const uint64_t NO_DST      = ~0ull;
+  using Buffers   = std::vector<MemEventBase::dataVec>;
+  using Transform = std::function<void( Buffers& )>;
+
+  struct Segment {
+    uint64_t              dst   = NO_DST;
+    std::vector<uint64_t> srcs;             // SRAM or DRAM source addresses
+    const uint8_t*        local = nullptr;  // read from FSM memory instead of srcs
+    uint64_t              bytes = 0;
+  };
+
+  DMAEngine( TCLPIM* p );
+  void start( uint64_t dst, uint64_t src, uint64_t numBytes );
+  void start(
+    uint64_t dst, const std::vector<uint64_t>& srcs, uint64_t numBytes, Transform xform, bool inOrder = false
+  );
+  void start( const std::vector<Segment>& segs, Transform xform = nullptr, bool inOrder = false );
+  bool clock();  // return true when the transfer is complete
+  bool busy() { return active; }
+  void stop();  // issue no further reads. Chunks already read still complete.
+
+private:
+  enum class CHUNK_STATE { FREE, READING, READY, WRITING };
+
+  struct Chunk {
+    CHUNK_STATE state        = CHUNK_STATE::FREE;
+    uint64_t    seq          = 0;
+    uint64_t    dst          = 0;
+    unsigned    readsPending = 0;
+    Buffers     buffers;  // one per source
+  };
+
+  TCLPIM*              parent;
+  std::vector<Chunk>   chunks;
+  Transform            xform;
+  bool                 active    = false;
+  bool                 inOrder   = false;
+  std::vector<Segment> segs;
+  size_t               segIdx    = 0;  // segment being read
+  uint64_t             segOff    = 0;  // bytes of it already read
+  uint64_t             remaining = 0;  // bytes not yet read
+  uint64_t             nextSeq   = 0;  // tag for the next chunk read
+  uint64_t             nextOut   = 0;  // next chunk to transform when inOrder
+  unsigned             readsInFlight  = 0;  // chunks waiting on DRAM reads
+  unsigned             writesInFlight = 0;
+
+  bool isSRAM( uint64_t addr, const char* what );
+  void issueRead();
+  void issueWrite();
+  void readDone( Chunk& c );
+  int  freeChunk();
+  int  oldestReadyChunk();
+};  //class DMAEngine
+
+// Ordered output stream for function FSMs that produce results a few bytes
+// at a time. Producers append to data() and call flush() every cycle. Each
+// flush writes at most one chunk to the next stream addresses, with up to
+// dmaMaxWrites DRAM writes in flight, and writes a partial chunk only once
+// the producer passes last. SRAM writes complete in the issuing cycle.
+class OutStream {
+public:
+  OutStream( TCLPIM* p );
+  // Continue at addr. Writes issued before the restart may still be in
+  // flight. chunkBytes 0 selects dmaChunkBytes.
+  void start( uint64_t addr, uint64_t chunkBytes = 0 );
+  // otherWrites: writes the owning FSM has in flight under the same cap
+  void                   flush( bool last, unsigned otherWrites = 0 );
+  MemEventBase::dataVec& data() { return out; }  // bytes not yet written
+  size_t                 size() const { return out.size(); }
+  bool                   empty() const { return out.empty(); }
+  bool                   done() const { return out.empty() && writesInFlight == 0; }
+  uint64_t               written() const { return next - base; }  // bytes handed to writes since start
+  unsigned               writes() const { return writesInFlight; }
+
+  template<typename T>
+  void push( const T& v ) {
+    size_t off = out.size();
+    out.resize( off + sizeof( T ) );
+    std::memcpy( &out[off], &v, sizeof( T ) );
+  }
+
+private:
+  TCLPIM*               parent;
+  MemEventBase::dataVec out;
+  uint64_t              base           = 0;
+  uint64_t              next           = 0;  // address of out[0]
+  uint64_t              chunk          = 0;
+  unsigned              writesInFlight = 0;
+};  //class OutStream
+
+}  // namespace SST::PIM
+
+#endif  //_SST_PIMBACKEND_TCL_PIM_DMA_
@@ -5,11 +5,15 @@
 // See LICENSE in the top level directory for licensing details
 //
 
+#include <algorithm>
+#include <cstring>
+#include <map>
+
 #include "tclpim_functions.h"
 
 namespace SST::PIM {
 
-MemCopy::MemCopy( TCLPIM* p ) : FSM( p ) {};
+MemCopy::MemCopy( TCLPIM* p ) : FSM( p ), dma( p ) {};
 
 // Param 0: Destination Address
 // Param 1: Source Address
@@ -20,88 +24,512 @@ void MemCopy::start( uint64_t params[NUM_FUNC_PARAMS] ) {
   if( numBytes == 0 )
     return;
   assert((numBytes%8)==0);
-  dst    = params[0];
-  src    = params[1];
-  total_words  = numBytes/8;
-  word_counter = numBytes/8;
-  dma_state    = DMA_STATE::READ;
   parent->output->verbose(
-    CALL_INFO, 3, 0, "start dma: dst=0x%" PRIx64 " src=0x%" PRIx64 " total_words=%" PRId64 "\n", dst, src, total_words
+    CALL_INFO, 3, 0, "start dma: dst=0x%" PRIx64 " src=0x%" PRIx64 " total_words=%" PRId64 "\n", params[0], params[1], numBytes/8
   );
+  dma.start( params[0], params[1], numBytes );
+}
+
+bool MemCopy::clock() {
+  if( !dma.clock() )
+    return false;
+  parent->output->verbose( CALL_INFO, 1, 0, "DMA Done\n" );
+  return true;  // finished!
+}
+
+MemSet::MemSet( TCLPIM* p ) : FSM( p ), dma( p ) {};
+
+// Param 0: Destination Address
+// Param 1: Fill Pattern ( low Pattern Bytes bytes, repeated )
+// Param 2: Number of Bytes ( multiple of Pattern Bytes )
+// Param 3: Pattern Bytes ( 1, 2, 4 or 8; 0 selects 1 )
 
-  // TODO check for overlapping ranges
-  auto dst_inf = parent->getDecodeInfo(dst);
-  auto src_inf = parent->getDecodeInfo(src);
-  if ( dst_inf.isIO && (dst_inf.pimAccType != PIM_ACCESS_TYPE::SRAM ) )
-    parent->output->fatal(CALL_INFO, -1, "Destination address must by SRAM or DRAM\n");
-  if ( src_inf.isIO && (src_inf.pimAccType != PIM_ACCESS_TYPE::SRAM ) )
-    parent->output->fatal(CALL_INFO, -1, "Source address must by SRAM or DRAM\n");
+void MemSet::start( uint64_t params[NUM_FUNC_PARAMS] ) {
+  uint64_t dst          = params[0];
+  uint64_t fill         = params[1];
+  uint64_t numBytes     = params[2];
+  unsigned patternBytes = params[3] ? params[3] : 1;
+  if( patternBytes != 1 && patternBytes != 2 && patternBytes != 4 && patternBytes != 8 )
+    parent->output->fatal( CALL_INFO, -1, "MemSet: pattern size %u must be 1, 2, 4 or 8 bytes\n", patternBytes );
+  if( numBytes % patternBytes )
+    parent->output->fatal( CALL_INFO, -1, "MemSet: size %" PRId64 " is not a multiple of the pattern\n", numBytes );
 
-  dst_is_sram = dst_inf.isIO && (dst_inf.pimAccType == PIM_ACCESS_TYPE::SRAM );
-  src_is_sram = src_inf.isIO && (src_inf.pimAccType == PIM_ACCESS_TYPE::SRAM );
+  // Chunks start on chunk boundaries of dst, so every chunk begins the pattern afresh
+  uint64_t chunkBytes = parent->getConfig().dmaChunkBytes;
+  pattern.resize( chunkBytes );
+  for( uint64_t off = 0; off < chunkBytes; off += patternBytes )
+    std::memcpy( &pattern[off], &fill, patternBytes );
+  std::vector<DMAEngine::Segment> segs( ( numBytes + chunkBytes - 1 ) / chunkBytes );
+  for( uint64_t i = 0; i < segs.size(); i++ ) {
+    segs[i].dst   = dst + i * chunkBytes;
+    segs[i].local = pattern.data();
+    segs[i].bytes = std::min( chunkBytes, numBytes - i * chunkBytes );
+  }
+  parent->output->verbose(
+    CALL_INFO, 3, 0, "MemSet: dst=0x%" PRIx64 " pattern=0x%" PRIx64 " pattern_bytes=%u bytes=%" PRId64 "\n", dst, fill,
+    patternBytes, numBytes
+  );
+  dma.start( segs );
 }
 
-bool MemCopy::clock() {
-#if 1
-  unsigned words = word_counter >= 64 ? 64 : word_counter;
-#else
-  unsigned words = 1;
-#endif
-  unsigned bytes = words * sizeof( uint64_t );
-  parent->buffer.resize( bytes );
-  switch (dma_state) {
-    case DMA_STATE::READ:
-      if (src_is_sram) {
-        parent->read( src, bytes, parent->buffer);
-        dma_state = DMA_STATE::WRITE;
-      } else {
-        sequence_dram_read(DMA_STATE::WRITE);
-        dma_state = DMA_STATE::WAITING;
+bool MemSet::clock() {
+  return dma.clock();
+}
+
+MemCompare::MemCompare( TCLPIM* p ) : FSM( p ), dma( p ) {};
+
+// Param 0: Result Address (SRAM). Receives the memcmp result ( A byte - B byte
+//          at the first difference, 0 if equal ) and the offset of the first
+//          difference ( Number of Bytes if equal ).
+// Param 1: Source A Address
+// Param 2: Source B Address
+// Param 3: Number of Bytes
+
+void MemCompare::start( uint64_t params[NUM_FUNC_PARAMS] ) {
+  result            = params[0];
+  uint64_t numBytes = params[3];
+  auto     inf      = parent->getDecodeInfo( result );
+  if( !inf.isIO || inf.pimAccType != PIM_ACCESS_TYPE::SRAM )
+    parent->output->fatal( CALL_INFO, -1, "MemCompare: result address 0x%" PRIx64 " must be SRAM\n", result );
+
+  offset = 0;
+  diff   = 0;
+  found  = false;
+  parent->output->verbose(
+    CALL_INFO, 3, 0, "MemCompare: a=0x%" PRIx64 " b=0x%" PRIx64 " bytes=%" PRId64 "\n", params[1], params[2], numBytes
+  );
+  dma.start( DMAEngine::NO_DST, { params[1], params[2] }, numBytes, [this]( DMAEngine::Buffers& b ) {
+    // Chunks read before the difference was found still drain through here
+    if( found )
+      return;
+    auto m = std::mismatch( b[0].begin(), b[0].end(), b[1].begin() );
+    if( m.first == b[0].end() ) {
+      offset += b[0].size();
+      return;
+    }
+    found = true;
+    offset += m.first - b[0].begin();
+    diff = int64_t( *m.first ) - int64_t( *m.second );
+    dma.stop();
+  }, true );
+}
+
+bool MemCompare::clock() {
+  if( !dma.clock() )
+    return false;
+  uint64_t              words[2] = { uint64_t( diff ), offset };
+  MemEventBase::dataVec d( sizeof( words ) );
+  std::memcpy( d.data(), words, d.size() );
+  parent->write( result, d.size(), &d );
+  return true;
+}
+
+MemSearch::MemSearch( TCLPIM* p ) : FSM( p ), dma( p ) {};
+
+// Param 0: Result Address (SRAM). Receives the offset of the first match
+//          ( Haystack Bytes if there is none ).
+// Param 1: Haystack Address
+// Param 2: Haystack Bytes
+// Param 3: Needle. The needle bytes themselves when Needle Bytes <= 8,
+//          otherwise the SRAM address of the needle.
+// Param 4: Needle Bytes ( 0 selects 1, a memchr )
+
+void MemSearch::start( uint64_t params[NUM_FUNC_PARAMS] ) {
+  result               = params[0];
+  uint64_t numBytes    = params[2];
+  uint64_t needleBytes = params[4] ? params[4] : 1;
+  auto     inf         = parent->getDecodeInfo( result );
+  if( !inf.isIO || inf.pimAccType != PIM_ACCESS_TYPE::SRAM )
+    parent->output->fatal( CALL_INFO, -1, "MemSearch: result address 0x%" PRIx64 " must be SRAM\n", result );
+  // Check the needle fits before sizing the buffer for it
+  if( needleBytes > sizeof( params[3] ) ) {
+    inf = parent->getDecodeInfo( params[3] );
+    if( !inf.isIO || inf.pimAccType != PIM_ACCESS_TYPE::SRAM || needleBytes > SRAM_SIZE - ( params[3] - SRAM_BASE ) % SRAM_SIZE )
+      parent->output->fatal( CALL_INFO, -1, "MemSearch: a needle of %" PRId64 " bytes must be in SRAM\n", needleBytes );
+  }
+  needle.resize( needleBytes );
+  if( needleBytes <= sizeof( params[3] ) )
+    std::memcpy( needle.data(), &params[3], needleBytes );
+  else
+    parent->read( params[3], needleBytes, needle );
+
+  match = numBytes;
+  base  = 0;
+  window.clear();
+  parent->output->verbose(
+    CALL_INFO, 3, 0, "MemSearch: haystack=0x%" PRIx64 " bytes=%" PRId64 " needle_bytes=%" PRId64 "\n", params[1],
+    numBytes, needleBytes
+  );
+  if( needleBytes > numBytes )
+    return;
+  dma.start( DMAEngine::NO_DST, { params[1] }, numBytes, [this, numBytes]( DMAEngine::Buffers& b ) {
+    if( match != numBytes )
+      return;
+    window.insert( window.end(), b[0].begin(), b[0].end() );
+    auto it = std::search( window.begin(), window.end(), needle.begin(), needle.end() );
+    if( it != window.end() ) {
+      match = base + ( it - window.begin() );
+      dma.stop();
+      return;
+    }
+    // Keep the bytes that could still start a match
+    size_t keep = std::min( window.size(), needle.size() - 1 );
+    base += window.size() - keep;
+    window.erase( window.begin(), window.end() - keep );
+  }, true );
+}
+
+bool MemSearch::clock() {
+  if( !dma.clock() )
+    return false;
+  MemEventBase::dataVec d( sizeof( match ) );
+  std::memcpy( d.data(), &match, sizeof( match ) );
+  parent->write( result, d.size(), &d );
+  return true;
+}
+
+Copy2D::Copy2D( TCLPIM* p ) : FSM( p ), dma( p ) {};
+
+// Param 0: Destination Address
+// Param 1: Source Address
+// Param 2: Number of Rows
+// Param 3: Row Bytes
+// Param 4: Source Pitch in bytes ( 0 selects Row Bytes )
+// Param 5: Destination Pitch in bytes ( 0 packs destination rows )
+// Param 6: Transpose Element Bytes ( 0 copies without transposing )
+
+void Copy2D::start( uint64_t params[NUM_FUNC_PARAMS] ) {
+  dst               = params[0];
+  uint64_t src      = params[1];
+  rows              = params[2];
+  rowBytes          = params[3];
+  uint64_t srcPitch = params[4] ? params[4] : rowBytes;
+  elemBytes         = params[6];
+  // Transposed destination rows hold one source column
+  dstPitch = params[5] ? params[5] : elemBytes ? rows * elemBytes : rowBytes;
+  loaded   = 0;
+  if( elemBytes && ( rowBytes % elemBytes ) != 0 )
+    parent->output->fatal( CALL_INFO, -1, "Copy2D: row bytes %" PRId64 " is not a multiple of the element size\n", rowBytes );
+  if( elemBytes && rows * rowBytes > parent->getConfig().dmaTileBytes )
+    parent->output->fatal( CALL_INFO, -1, "Copy2D: %" PRId64 " byte tile exceeds dma_tile_bytes\n", rows * rowBytes );
+  parent->output->verbose(
+    CALL_INFO, 3, 0, "Copy2D: dst=0x%" PRIx64 " src=0x%" PRIx64 " rows=%" PRId64 " row_bytes=%" PRId64 " src_pitch=%" PRId64
+    " dst_pitch=%" PRId64 " transpose=%u\n", dst, src, rows, rowBytes, srcPitch, dstPitch, elemBytes
+  );
+
+  std::vector<DMAEngine::Segment> segs( rows );
+  for( uint64_t r = 0; r < rows; r++ ) {
+    segs[r].dst   = elemBytes ? DMAEngine::NO_DST : dst + r * dstPitch;
+    segs[r].srcs  = { src + r * srcPitch };
+    segs[r].bytes = rowBytes;
+  }
+  if( !elemBytes ) {
+    phase = PHASE::COPY;
+    dma.start( segs );
+    return;
+  }
+
+  // Source rows arrive in order and scatter into the transposed tile
+  buffer.resize( rows * rowBytes );
+  phase = PHASE::LOAD;
+  dma.start( segs, [this]( DMAEngine::Buffers& b ) {
+    // An element cut by a chunk boundary is finished by the next chunk
+    const uint8_t* p = b[0].data();
+    for( size_t off = 0; off < b[0].size(); ) {
+      uint64_t r = loaded / rowBytes;
+      uint64_t c = ( loaded % rowBytes ) / elemBytes;
+      uint64_t e = ( loaded % rowBytes ) % elemBytes;
+      size_t   n = std::min<size_t>( elemBytes - e, b[0].size() - off );
+      std::memcpy( &buffer[( c * rows + r ) * elemBytes + e], p + off, n );
+      off += n;
+      loaded += n;
+    }
+  }, true );
+}
+
+bool Copy2D::clock() {
+  if( phase == PHASE::IDLE || !dma.clock() )
+    return phase == PHASE::IDLE;
+  if( phase == PHASE::LOAD ) {
+    // Write one destination row per source column
+    uint64_t                        cols = rowBytes / elemBytes;
+    std::vector<DMAEngine::Segment> segs( cols );
+    for( uint64_t c = 0; c < cols; c++ ) {
+      segs[c].dst   = dst + c * dstPitch;
+      segs[c].local = &buffer[c * rows * elemBytes];
+      segs[c].bytes = rows * elemBytes;
+    }
+    phase = PHASE::STORE;
+    dma.start( segs );
+    return false;
+  }
+  phase = PHASE::IDLE;
+  return true;
+}
+
+IndexedAccess::IndexedAccess( TCLPIM* p, bool scatter ) : FSM( p ), scatter( scatter ) {
+  windows.resize( NUM_WINDOWS );
+};
+
+// Param 0: Destination Address
+// Param 1: Source Address
+// Param 2: Index Array Address
+// Param 3: Number of Elements
+// Param 4: Element Bytes ( 1, 2, 4 or 8; 0 selects 8 )
+// Param 5: Index Bytes ( 4 or 8; 0 selects 8 ). Indices are unsigned element offsets.
+
+void IndexedAccess::start( uint64_t params[NUM_FUNC_PARAMS] ) {
+  dst       = params[0];
+  src       = params[1];
+  idxAddr   = params[2];
+  numElems  = params[3];
+  elemBytes = params[4] ? params[4] : 8;
+  idxBytes  = params[5] ? params[5] : 8;
+  if( elemBytes != 1 && elemBytes != 2 && elemBytes != 4 && elemBytes != 8 )
+    parent->output->fatal( CALL_INFO, -1, "Element size %u must be 1, 2, 4 or 8 bytes\n", elemBytes );
+  if( idxBytes != 4 && idxBytes != 8 )
+    parent->output->fatal( CALL_INFO, -1, "Index size %u must be 4 or 8 bytes\n", idxBytes );
+  // Aligned elements never straddle a burst
+  if( ( scatter ? dst : src ) % elemBytes )
+    parent->output->fatal( CALL_INFO, -1, "Indexed base address must be element aligned\n" );
+  isSRAM( dst );
+  isSRAM( src );
+  isSRAM( idxAddr );
+
+  winElems    = parent->getConfig().dmaChunkBytes / std::max( elemBytes, idxBytes );
+  nextElem    = 0;
+  nextSeq     = 0;
+  nextStore   = 0;
+  outstanding = 0;
+  for( auto& w : windows )
+    assert( w.state == WIN_STATE::FREE );
+  parent->output->verbose(
+    CALL_INFO, 3, 0, "%s: dst=0x%" PRIx64 " src=0x%" PRIx64 " idx=0x%" PRIx64 " elems=%" PRId64 " elem_bytes=%u idx_bytes=%u\n",
+    scatter ? "Scatter" : "Gather", dst, src, idxAddr, numElems, elemBytes, idxBytes
+  );
+}
+
+bool IndexedAccess::clock() {
+  // One DRAM read and one DRAM write may issue per cycle
+  readIssued  = false;
+  writeIssued = false;
+  access();
+  load();
+
+  if( nextElem < numElems )
+    return false;
+  for( auto& w : windows )
+    if( w.state != WIN_STATE::FREE )
+      return false;
+  return true;
+}
+
+bool IndexedAccess::isSRAM( uint64_t addr ) {
+  auto inf = parent->getDecodeInfo( addr );
+  if( inf.isIO && inf.pimAccType != PIM_ACCESS_TYPE::SRAM )
+    parent->output->fatal( CALL_INFO, -1, "Indexed access address 0x%" PRIx64 " must be SRAM or DRAM\n", addr );
+  return inf.isIO;
+}
+
+bool IndexedAccess::canIssue( uint64_t addr, bool isWrite ) {
+  return isSRAM( addr ) || !( isWrite ? writeIssued : readIssued );
+}
+
+// SRAM completes immediately. DRAM read data lands in *d before done runs.
+void IndexedAccess::issue( uint64_t addr, MemEventBase::dataVec* d, bool isWrite, std::function<void()> done ) {
+  if( isSRAM( addr ) ) {
+    if( isWrite )
+      parent->write( addr, d->size(), d );
+    else
+      parent->read( addr, d->size(), *d );
+    done();
+    return;
+  }
+  ( isWrite ? writeIssued : readIssued ) = true;
+  parent->m_issueDRAMRequest( addr, d, isWrite, [d, isWrite, done]( const MemEventBase::dataVec& r ) {
+    if( !isWrite ) {
+      assert( r.size() == d->size() );
+      *d = r;
+    }
+    done();
+  } );
+}
+
+uint64_t IndexedAccess::index( const Window& w, unsigned slot ) {
+  uint64_t i = 0;
+  std::memcpy( &i, &w.idx[slot * idxBytes], idxBytes );
+  return i;
+}
+
+// Finish a partially issued window load, else open the next window
+void IndexedAccess::load() {
+  for( unsigned wi = 0; wi < windows.size(); wi++ ) {
+    Window& w = windows[wi];
+    if( w.state == WIN_STATE::LOADING && w.loadsIssued < ( scatter ? 2u : 1u ) ) {
+      issueLoads( wi );
+      return;
+    }
+  }
+  if( nextElem == numElems )
+    return;
+  for( unsigned wi = 0; wi < windows.size(); wi++ ) {
+    Window& w = windows[wi];
+    if( w.state != WIN_STATE::FREE )
+      continue;
+    w.seq          = nextSeq++;
+    w.first        = nextElem;
+    w.count        = std::min<uint64_t>( winElems, numElems - nextElem );
+    w.loadsIssued  = 0;
+    w.loadsPending = scatter ? 2 : 1;
+    w.state        = WIN_STATE::LOADING;
+    w.idx.resize( w.count * idxBytes );
+    w.data.resize( w.count * elemBytes );
+    nextElem += w.count;
+    issueLoads( wi );
+    return;
+  }
+}
+
+// Index chunk, then the contiguous scatter sources
+void IndexedAccess::issueLoads( unsigned wi ) {
+  Window&  w    = windows[wi];
+  uint64_t seq  = w.seq;
+  auto     done = [this, wi, seq]() {
+    Window& lw = windows[wi];
+    assert( lw.state == WIN_STATE::LOADING && lw.seq == seq && lw.loadsPending > 0 );
+    if( --lw.loadsPending == 0 )
+      loaded( lw );
+  };
+  if( w.loadsIssued == 0 ) {
+    uint64_t a = idxAddr + w.first * idxBytes;
+    if( !canIssue( a, false ) )
+      return;
+    w.loadsIssued++;
+    issue( a, &w.idx, false, done );
+  }
+  if( scatter && w.loadsIssued == 1 ) {
+    uint64_t a = src + w.first * elemBytes;
+    if( !canIssue( a, false ) )
+      return;
+    w.loadsIssued++;
+    issue( a, &w.data, false, done );
+  }
+}
+
+void IndexedAccess::loaded( Window& w ) {
+  buildRuns( w );
+  w.state = WIN_STATE::ACCESSING;
+}
+
+void IndexedAccess::buildRuns( Window& w ) {
+  w.runs.clear();
+  w.nextRun     = 0;
+  w.runsPending = 0;
+  uint64_t base = scatter ? dst : src;
+  // SRAM has no bursts to share
+  uint64_t burst = isSRAM( base ) ? elemBytes : parent->getConfig().gsBurstBytes;
+
+  if( !scatter ) {
+    // One read per distinct burst, fanned out to every slot that hits it
+    std::map<uint64_t, size_t> burstRun;
+    for( unsigned slot = 0; slot < w.count; slot++ ) {
+      uint64_t a = base + index( w, slot ) * elemBytes;
+      uint64_t b = a & ~( burst - 1 );
+      auto     r = burstRun.find( b );
+      if( r == burstRun.end() ) {
+        r = burstRun.emplace( b, w.runs.size() ).first;
+        w.runs.emplace_back();
+        w.runs.back().addr = b;
+        w.runs.back().data.resize( burst );
       }
-      src += bytes;
-      break;
-    case DMA_STATE::WRITE:
-    {
-      assert( word_counter >= words );
-      word_counter = word_counter - words;
-      DMA_STATE nextState = (word_counter > 0) ? DMA_STATE::READ : DMA_STATE::DONE;
-      if (dst_is_sram) {
-        parent->write( dst, bytes, &parent->buffer);
-        dma_state = nextState;
-      } else {
-        sequence_dram_write(nextState);
-        dma_state = DMA_STATE::WAITING;
+      w.runs[r->second].slots.push_back( slot );
+    }
+  } else {
+    // Last writer wins, then merge address-adjacent elements within a burst
+    std::map<uint64_t, unsigned> last;
+    for( unsigned slot = 0; slot < w.count; slot++ )
+      last[base + index( w, slot ) * elemBytes] = slot;
+    for( auto& e : last ) {
+      uint64_t a = e.first;
+      if( w.runs.empty() || w.runs.back().addr + w.runs.back().data.size() != a ||
+          ( w.runs.back().addr & ~( burst - 1 ) ) != ( a & ~( burst - 1 ) ) ) {
+        w.runs.emplace_back();
+        w.runs.back().addr = a;
       }
-      dst += bytes;
-      break;
+      Run& r = w.runs.back();
+      r.slots.push_back( e.second );
+      r.data.insert( r.data.end(), &w.data[e.second * elemBytes], &w.data[e.second * elemBytes] + elemBytes );
     }
-    case DMA_STATE::DONE:
-      parent->output->verbose( CALL_INFO, 1, 0, "DMA Done\n" );
-      dma_state = DMA_STATE::IDLE;
-      return true;  // finished!
-    default:
-      break;
   }
-  return false;
+  parent->output->verbose(
+    CALL_INFO, 4, 0, "%s window seq=%" PRId64 " elems=%u requests=%zu\n",
+    scatter ? "Scatter" : "Gather", w.seq, w.count, w.runs.size()
+  );
 }
 
-void MemCopy::sequence_dram_read(DMA_STATE nextState)
-{
-  parent->m_issueDRAMRequest(src, &parent->buffer, false, [this, nextState]( const MemEventBase::dataVec& d ) 
-    {
-      assert( parent->buffer.size() == d.size() );
-      for( size_t i = 0; i < d.size(); i++ ) {
-        parent->buffer[i] = d[i];
+// Issue the next element request from the oldest window with work
+void IndexedAccess::access() {
+  // Completed gather windows write their contiguous output
+  for( unsigned wi = 0; wi < windows.size(); wi++ ) {
+    Window&  w = windows[wi];
+    uint64_t a = dst + w.first * elemBytes;
+    if( w.state != WIN_STATE::STORE || !canIssue( a, true ) )
+      continue;
+    w.state      = WIN_STATE::WRITING;
+    uint64_t seq = w.seq;
+    issue( a, &w.data, true, [this, wi, seq]() {
+      assert( windows[wi].state == WIN_STATE::WRITING && windows[wi].seq == seq );
+      windows[wi].state = WIN_STATE::FREE;
+    } );
+    break;
+  }
+
+  int sel = -1;
+  for( unsigned wi = 0; wi < windows.size(); wi++ ) {
+    Window& w = windows[wi];
+    if( w.state != WIN_STATE::ACCESSING || w.nextRun == w.runs.size() )
+      continue;
+    if( scatter && w.seq != nextStore )
+      continue;
+    if( sel < 0 || w.seq < windows[sel].seq )
+      sel = wi;
+  }
+  if( sel < 0 || outstanding >= parent->getConfig().gsMaxOutstanding )
+    return;
+  Window& w   = windows[sel];
+  size_t  ri  = w.nextRun;
+  Run&    r   = w.runs[ri];
+  if( !canIssue( r.addr, scatter ) )
+    return;
+  w.nextRun++;
+  w.runsPending++;
+  outstanding++;
+  uint64_t seq = w.seq;
+  issue( r.addr, &r.data, scatter, [this, sel, ri, seq]() {
+    Window& rw = windows[sel];
+    assert( rw.state == WIN_STATE::ACCESSING && rw.seq == seq );
+    if( !scatter ) {
+      const Run& rr = rw.runs[ri];
+      for( unsigned slot : rr.slots ) {
+        uint64_t off = src + index( rw, slot ) * elemBytes - rr.addr;
+        std::memcpy( &rw.data[slot * elemBytes], &rr.data[off], elemBytes );
       }
-      dma_state = nextState;
-    });
+    }
+    outstanding--;
+    rw.runsPending--;
+    runDone( rw );
+  } );
 }
 
-void MemCopy::sequence_dram_write(DMA_STATE nextState)
-{
-  parent->m_issueDRAMRequest( dst, &parent->buffer, true, [this, nextState]( const MemEventBase::dataVec& d ) {
-    dma_state = nextState;
-  } );
+void IndexedAccess::runDone( Window& w ) {
+  if( w.nextRun < w.runs.size() || w.runsPending > 0 )
+    return;
+  if( scatter ) {
+    w.state = WIN_STATE::FREE;
+    nextStore++;
+  } else {
+    w.state = WIN_STATE::STORE;
+  }
 }
 
 } // namespace
\ No newline at end of file
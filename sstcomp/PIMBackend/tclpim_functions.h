@@ -9,6 +9,7 @@
 #define _SST_PIMBACKEND_TCL_PIM_FUNCTIONS_
 
 #include "tclpim.h"
+#include "tclpim_dma.h"
 
 namespace SST::PIM {
 
@@ -19,20 +20,149 @@ public:
   void start( uint64_t params[NUM_FUNC_PARAMS] ) override;
   bool clock() override;
 private:
-  enum DMA_STATE { IDLE, READ, WRITE, WAITING, DONE };
-  DMA_STATE dma_state    = DMA_STATE::IDLE;
-  uint64_t  total_words  = 0;
-  uint64_t  word_counter = 0;
-  uint64_t  src          = 0;
-  uint64_t  dst          = 0;
-  bool src_is_sram          = false;
-  bool dst_is_sram          = false;
-  void sequence_dram_read(DMA_STATE nextState);
-  void sequence_dram_write(DMA_STATE nextState);
+  DMAEngine dma;
 };  //class MemCopy
 
+// Fill with a repeating 1, 2, 4 or 8 byte pattern. There is no read phase:
+// every chunk is sourced from one pattern buffer held by the FSM, so only
+// DRAM writes are issued.
+class MemSet : public FSM {
+public:
+  MemSet( TCLPIM* p );
+  virtual ~MemSet() {};
+  void start( uint64_t params[NUM_FUNC_PARAMS] ) override;
+  bool clock() override;
+private:
+  DMAEngine             dma;
+  MemEventBase::dataVec pattern;  // one chunk of the repeated pattern
+};  //class MemSet
+
+// Byte compare of two ranges. Chunks are compared in address order and no
+// further reads are issued once a difference is found. The result is the
+// libc memcmp value and the offset of the first difference.
+class MemCompare : public FSM {
+public:
+  MemCompare( TCLPIM* p );
+  virtual ~MemCompare() {};
+  void start( uint64_t params[NUM_FUNC_PARAMS] ) override;
+  bool clock() override;
+private:
+  DMAEngine dma;
+  uint64_t  result = 0;
+  uint64_t  offset = 0;  // bytes compared so far, or the first difference
+  int64_t   diff   = 0;
+  bool      found  = false;
+};  //class MemCompare
+
+// First occurrence of a byte (memchr) or byte string (memmem). The haystack
+// streams in address order with the last needle bytes - 1 of each chunk
+// carried over so matches across chunk boundaries are found. Reads stop at
+// the first match.
+class MemSearch : public FSM {
+public:
+  MemSearch( TCLPIM* p );
+  virtual ~MemSearch() {};
+  void start( uint64_t params[NUM_FUNC_PARAMS] ) override;
+  bool clock() override;
+private:
+  DMAEngine            dma;
+  uint64_t             result = 0;
+  uint64_t             match  = 0;  // offset of the first match, haystack bytes if none
+  uint64_t             base   = 0;  // haystack offset of window[0]
+  std::vector<uint8_t> needle;
+  std::vector<uint8_t> window;  // carried tail followed by the latest chunk
+};  //class MemSearch
+
+// Strided 2-D copy: rows of rowBytes from src (srcPitch apart) to dst
+// (dstPitch apart) as one pipelined transfer. With an element size given
+// the tile is transposed in flight: element (r,c) lands in dst row c at
+// column r. A transposed tile is staged whole, up to dmaTileBytes.
+class Copy2D : public FSM {
+public:
+  Copy2D( TCLPIM* p );
+  virtual ~Copy2D() {};
+  void start( uint64_t params[NUM_FUNC_PARAMS] ) override;
+  bool clock() override;
+private:
+  enum class PHASE { IDLE, COPY, LOAD, STORE };
+  DMAEngine dma;
+  PHASE     phase     = PHASE::IDLE;
+  uint64_t  dst       = 0;
+  uint64_t  rows      = 0;
+  uint64_t  rowBytes  = 0;
+  uint64_t  dstPitch  = 0;
+  unsigned  elemBytes = 0;
+  uint64_t  loaded    = 0;  // tile bytes transposed so far
+};  //class Copy2D
+
+// Index driven element access.
+//   Gather:  dst[i] = src[idx[i]]
+//   Scatter: dst[idx[i]] = src[i] (the last duplicate index wins)
+// The index array streams through a few windows. Element addresses in a
+// window are grouped by gsBurstBytes so each burst is fetched once (gather)
+// or adjacent elements merge into one write (scatter). Scatter windows store
+// in index order so duplicates across windows resolve like a loop.
+class IndexedAccess : public FSM {
+public:
+  IndexedAccess( TCLPIM* p, bool scatter );
+  virtual ~IndexedAccess() {};
+  void start( uint64_t params[NUM_FUNC_PARAMS] ) override;
+  bool clock() override;
+private:
+  static const unsigned NUM_WINDOWS = 4;
+  enum class WIN_STATE { FREE, LOADING, ACCESSING, STORE, WRITING };
+
+  // One element request: a gather burst read or a scatter run write
+  struct Run {
+    uint64_t              addr = 0;
+    MemEventBase::dataVec data;
+    std::vector<unsigned> slots;  // window element slots served by this run
+  };
+
+  struct Window {
+    WIN_STATE             state        = WIN_STATE::FREE;
+    uint64_t              seq          = 0;
+    uint64_t              first        = 0;  // first element number
+    unsigned              count        = 0;
+    unsigned              loadsIssued  = 0;
+    unsigned              loadsPending = 0;
+    MemEventBase::dataVec idx;
+    MemEventBase::dataVec data;  // gathered elements or scatter sources
+    std::vector<Run>      runs;
+    size_t                nextRun      = 0;
+    unsigned              runsPending  = 0;
+  };
+
+  bool                scatter;
+  std::vector<Window> windows;
+  uint64_t            dst        = 0;
+  uint64_t            src        = 0;
+  uint64_t            idxAddr    = 0;
+  uint64_t            numElems   = 0;
+  uint64_t            nextElem   = 0;  // next element to assign to a window
+  uint64_t            nextSeq    = 0;
+  uint64_t            nextStore  = 0;  // scatter window allowed to store
+  unsigned            elemBytes  = 8;
+  unsigned            idxBytes   = 8;
+  unsigned            winElems   = 0;
+  unsigned            outstanding = 0;  // element requests in flight
+  bool                readIssued  = false;  // DRAM read slot used this cycle
+  bool                writeIssued = false;  // DRAM write slot used this cycle
+
+  bool     isSRAM( uint64_t addr );
+  bool     canIssue( uint64_t addr, bool isWrite );
+  void     issue( uint64_t addr, MemEventBase::dataVec* d, bool isWrite, std::function<void()> done );
+  uint64_t index( const Window& w, unsigned slot );
+  void     load();
+  void     issueLoads( unsigned wi );
+  void     loaded( Window& w );
+  void     buildRuns( Window& w );
+  void     access();
+  void     runDone( Window& w );
+};  //class IndexedAccess
+
 
 } // namespace SST::PIM
 
 
-#endif //_SST_PIMBACKEND_TCL_PIM_FUNCTIONS_
\ No newline at end of file
+#endif //_SST_PIMBACKEND_TCL_PIM_FUNCTIONS_
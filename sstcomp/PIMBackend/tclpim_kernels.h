@@ -0,0 +1,610 @@
+//
+// Copyright (C) 2017-2024 Tactical Computing Laboratories, LLC
+// All Rights Reserved
+// contact@tactcomplabs.com
+// See LICENSE in the top level directory for licensing details
+//
+
+#ifndef _SST_PIMBACKEND_TCL_PIM_KERNELS_
+#define _SST_PIMBACKEND_TCL_PIM_KERNELS_
+
+#include <algorithm>
+#include <cassert>
+#include <cstdint>
+#include <cstring>
+#include <limits>
+#include <type_traits>
+
+#include "pimdef.h"
+
+// Vectorize the following loop. Needs -fopenmp-simd, ignored otherwise.
+#define PIM_SIMD _Pragma( "omp simd" )
+#define PIM_PRAGMA( x ) _Pragma( #x )
+#define PIM_SIMD_REDUCE( op, var ) PIM_PRAGMA( omp simd reduction( op : var ) )
+
+namespace SST::PIM::kernels {
+
+// Typed view of a staged payload. Payload storage comes from operator new and
+// chunk sizes are multiples of 8 bytes, so every element type is aligned.
+template<typename T, typename V>
+inline T* elems( V& v ) {
+  assert( reinterpret_cast<uintptr_t>( v.data() ) % alignof( T ) == 0 );
+  assert( v.size() % sizeof( T ) == 0 );
+  return reinterpret_cast<T*>( v.data() );
+}
+
+// Arithmetic type: integers wrap through an unsigned type at least as wide as int
+template<typename T>
+using arith_t = std::conditional_t<
+  std::is_floating_point_v<T>,
+  T,
+  std::conditional_t<( sizeof( T ) > 4 ), uint64_t, uint32_t>>;
+
+// Same width integer used for compare results and select masks
+template<typename T>
+using mask_t = std::conditional_t<
+  sizeof( T ) == 1,
+  int8_t,
+  std::conditional_t<sizeof( T ) == 2, int16_t, std::conditional_t<sizeof( T ) == 4, int32_t, int64_t>>>;
+
+// Reduction accumulator: integers widen to 64 bits and wrap, floats use fp64
+template<typename T>
+using accum_t = std::conditional_t<std::is_floating_point_v<T>, double, uint64_t>;
+
+// Element value from the low bytes of a 64-bit parameter
+template<typename T>
+inline T fromBits( uint64_t bits ) {
+  T v;
+  std::memcpy( &v, &bits, sizeof( T ) );
+  return v;
+}
+
+// In place: a = a op b
+template<typename T>
+void binary( EW_OP op, T* __restrict a, const T* __restrict b, size_t n ) {
+  using A = arith_t<T>;
+  switch( op ) {
+  case EW_OP::ADD:
+    PIM_SIMD for( size_t i = 0; i < n; i++ ) a[i] = T( A( a[i] ) + A( b[i] ) );
+    break;
+  case EW_OP::SUB:
+    PIM_SIMD for( size_t i = 0; i < n; i++ ) a[i] = T( A( a[i] ) - A( b[i] ) );
+    break;
+  case EW_OP::MUL:
+    PIM_SIMD for( size_t i = 0; i < n; i++ ) a[i] = T( A( a[i] ) * A( b[i] ) );
+    break;
+  case EW_OP::MIN:
+    PIM_SIMD for( size_t i = 0; i < n; i++ ) a[i] = b[i] < a[i] ? b[i] : a[i];
+    break;
+  case EW_OP::MAX:
+    PIM_SIMD for( size_t i = 0; i < n; i++ ) a[i] = a[i] < b[i] ? b[i] : a[i];
+    break;
+  default: assert( false );
+  }
+}
+
+// In place: a = alpha * a (+ b for AXPY)
+template<typename T>
+void scaled( EW_OP op, T alpha, T* __restrict a, const T* __restrict b, size_t n ) {
+  using A = arith_t<T>;
+  if( op == EW_OP::SCALE ) {
+    PIM_SIMD for( size_t i = 0; i < n; i++ ) a[i] = T( A( alpha ) * A( a[i] ) );
+  } else {
+    assert( op == EW_OP::AXPY );
+    PIM_SIMD for( size_t i = 0; i < n; i++ ) a[i] = T( A( alpha ) * A( a[i] ) + A( b[i] ) );
+  }
+}
+
+// In place: a = a op b ? ~0 : 0, written as same width masks
+template<typename T>
+void compare( EW_OP op, T* a, const T* __restrict b, size_t n ) {
+  using M = mask_t<T>;
+  M* m    = reinterpret_cast<M*>( a );
+  if( op == EW_OP::CMPEQ ) {
+    PIM_SIMD for( size_t i = 0; i < n; i++ ) m[i] = a[i] == b[i] ? M( -1 ) : M( 0 );
+  } else {
+    assert( op == EW_OP::CMPLT );
+    PIM_SIMD for( size_t i = 0; i < n; i++ ) m[i] = a[i] < b[i] ? M( -1 ) : M( 0 );
+  }
+}
+
+// In place: a = c ? a : b
+template<typename T>
+void select( T* __restrict a, const T* __restrict b, const mask_t<T>* __restrict c, size_t n ) {
+  PIM_SIMD for( size_t i = 0; i < n; i++ ) a[i] = c[i] ? a[i] : b[i];
+}
+
+// Apply an element-wise op to staged buffers (A, B, C). The result replaces A.
+template<typename T, typename B>
+void elementWise( EW_OP op, uint64_t alphaBits, B& bufs ) {
+  T*     a = elems<T>( bufs[0] );
+  size_t n = bufs[0].size() / sizeof( T );
+  switch( op ) {
+  case EW_OP::SCALE: scaled<T>( op, fromBits<T>( alphaBits ), a, nullptr, n ); break;
+  case EW_OP::AXPY: scaled<T>( op, fromBits<T>( alphaBits ), a, elems<T>( bufs[1] ), n ); break;
+  case EW_OP::CMPEQ:
+  case EW_OP::CMPLT: compare<T>( op, a, elems<T>( bufs[1] ), n ); break;
+  case EW_OP::SELECT: select<T>( a, elems<T>( bufs[1] ), elems<mask_t<T>>( bufs[2] ), n ); break;
+  default: binary<T>( op, a, elems<T>( bufs[1] ), n ); break;
+  }
+}
+
+// Reduction carried across chunks. Chunks must arrive in address order.
+template<typename T>
+class Reducer {
+public:
+  Reducer( RED_OP op ) : op( op ) {}
+
+  template<typename B>
+  void chunk( B& bufs ) {
+    using S       = accum_t<T>;
+    const T* a    = elems<T>( bufs[0] );
+    size_t   n    = bufs[0].size() / sizeof( T );
+    S        part = 0;
+    T        m    = a[0];
+    switch( op ) {
+    case RED_OP::SUM:
+      PIM_SIMD_REDUCE( +, part ) for( size_t i = 0; i < n; i++ ) part += S( a[i] );
+      sum += part;
+      break;
+    case RED_OP::DOT: {
+      const T* b = elems<T>( bufs[1] );
+      PIM_SIMD_REDUCE( +, part ) for( size_t i = 0; i < n; i++ ) part += S( a[i] ) * S( b[i] );
+      sum += part;
+      break;
+    }
+    case RED_OP::MIN:
+      PIM_SIMD_REDUCE( min, m ) for( size_t i = 0; i < n; i++ ) m = a[i] < m ? a[i] : m;
+      if( count == 0 || m < best )
+        best = m;
+      break;
+    case RED_OP::MAX:
+    case RED_OP::ARGMAX:
+      PIM_SIMD_REDUCE( max, m ) for( size_t i = 0; i < n; i++ ) m = m < a[i] ? a[i] : m;
+      if( count == 0 || best < m ) {
+        best = m;
+        if( op == RED_OP::ARGMAX )
+          for( size_t i = 0; i < n; i++ )
+            if( a[i] == m ) {
+              bestIdx = count + i;
+              break;
+            }
+      }
+      break;
+    }
+    count += n;
+  }
+
+  uint64_t value() const {
+    accum_t<T> r = 0;
+    if( op == RED_OP::SUM || op == RED_OP::DOT )
+      r = sum;
+    else if( count )
+      r = accum_t<T>( best );
+    uint64_t bits;
+    std::memcpy( &bits, &r, sizeof( bits ) );
+    return bits;
+  }
+
+  uint64_t index() const { return bestIdx; }
+
+private:
+  RED_OP     op;
+  accum_t<T> sum     = 0;
+  T          best    = T( 0 );
+  uint64_t   bestIdx = ~0ull;
+  uint64_t   count   = 0;
+};
+
+// Prefix scan carried across chunks. Chunks must arrive in address order.
+// Exclusive scans start from the identity of the operator.
+template<typename T>
+class Scanner {
+public:
+  Scanner( RED_OP op, bool exclusive ) : op( op ), exclusive( exclusive ) {
+    carry = op == RED_OP::MIN ? std::numeric_limits<T>::max() :
+            op == RED_OP::MAX ? std::numeric_limits<T>::lowest() :
+                                T( 0 );
+  }
+
+  // In place. The carry dependence keeps this loop scalar.
+  template<typename B>
+  void chunk( B& bufs ) {
+    using A  = arith_t<T>;
+    T*     a = elems<T>( bufs[0] );
+    size_t n = bufs[0].size() / sizeof( T );
+    for( size_t i = 0; i < n; i++ ) {
+      T x    = a[i];
+      T next = op == RED_OP::SUM ? T( A( carry ) + A( x ) ) :
+               op == RED_OP::MIN ? ( x < carry ? x : carry ) :
+                                   ( carry < x ? x : carry );
+      a[i]   = exclusive ? carry : next;
+      carry  = next;
+    }
+  }
+
+private:
+  RED_OP op;
+  bool   exclusive;
+  T      carry;
+};
+
+// m[i] = 1 where x[i] satisfies the predicate, see FILTER_OP
+template<typename T>
+void match( FILTER_OP op, T a, T b, const T* __restrict x, uint8_t* __restrict m, size_t n ) {
+  using U = std::make_unsigned_t<mask_t<T>>;
+  switch( op ) {
+  case FILTER_OP::EQ:
+    PIM_SIMD for( size_t i = 0; i < n; i++ ) m[i] = x[i] == a;
+    break;
+  case FILTER_OP::NE:
+    PIM_SIMD for( size_t i = 0; i < n; i++ ) m[i] = x[i] != a;
+    break;
+  case FILTER_OP::LT:
+    PIM_SIMD for( size_t i = 0; i < n; i++ ) m[i] = x[i] < a;
+    break;
+  case FILTER_OP::GT:
+    PIM_SIMD for( size_t i = 0; i < n; i++ ) m[i] = a < x[i];
+    break;
+  case FILTER_OP::RANGE:
+    PIM_SIMD for( size_t i = 0; i < n; i++ ) m[i] = !( x[i] < a ) && !( b < x[i] );
+    break;
+  case FILTER_OP::MASK: {
+    U         ua, ub;
+    const U*  u = reinterpret_cast<const U*>( x );
+    std::memcpy( &ua, &a, sizeof( U ) );
+    std::memcpy( &ub, &b, sizeof( U ) );
+    PIM_SIMD for( size_t i = 0; i < n; i++ ) m[i] = U( u[i] & ua ) == ub;
+    break;
+  }
+  }
+}
+
+// Append the selected elements, or their indices counted from first, to out
+template<typename T, typename V>
+size_t compact( const T* x, const uint8_t* m, size_t n, uint64_t first, bool indices, V& out ) {
+  size_t k = 0;
+  for( size_t i = 0; i < n; i++ )
+    k += m[i];
+  size_t w   = indices ? sizeof( uint64_t ) : sizeof( T );
+  size_t off = out.size();
+  out.resize( off + k * w );
+  uint8_t* o = out.data() + off;
+  for( size_t i = 0; i < n; i++ ) {
+    if( !m[i] )
+      continue;
+    if( indices ) {
+      uint64_t idx = first + i;
+      std::memcpy( o, &idx, w );
+    } else {
+      std::memcpy( o, &x[i], w );
+    }
+    o += w;
+  }
+  return k;
+}
+
+// y[j] = sum over k of w[k] * b[k * n + j] for one weight row. Integers
+// accumulate in wrapping A, floats in A. GEMV (n = 1) reduces across lanes,
+// otherwise the lanes run across the n outputs.
+template<typename T, typename A>
+void gemvRow( const T* __restrict w, const T* __restrict b, size_t cols, size_t n, A* __restrict y ) {
+  using U = arith_t<A>;
+  if( n == 1 ) {
+    U s = 0;
+    PIM_SIMD_REDUCE( +, s ) for( size_t k = 0; k < cols; k++ ) s += U( A( w[k] ) * A( b[k] ) );
+    y[0] = A( s );
+    return;
+  }
+  for( size_t j = 0; j < n; j++ )
+    y[j] = 0;
+  for( size_t k = 0; k < cols; k++ ) {
+    A        wk = A( w[k] );
+    const T* bk = b + k * n;
+    PIM_SIMD for( size_t j = 0; j < n; j++ ) y[j] = A( U( y[j] ) + U( wk * A( bk[j] ) ) );
+  }
+}
+
+// Call f with a value of the run-time element type
+template<typename F>
+void dispatchType( EW_TYPE t, F&& f ) {
+  switch( t ) {
+  case EW_TYPE::I8: f( int8_t() ); break;
+  case EW_TYPE::I16: f( int16_t() ); break;
+  case EW_TYPE::I32: f( int32_t() ); break;
+  case EW_TYPE::I64: f( int64_t() ); break;
+  case EW_TYPE::U8: f( uint8_t() ); break;
+  case EW_TYPE::U16: f( uint16_t() ); break;
+  case EW_TYPE::U32: f( uint32_t() ); break;
+  case EW_TYPE::U64: f( uint64_t() ); break;
+  case EW_TYPE::F32: f( float() ); break;
+  case EW_TYPE::F64: f( double() ); break;
+  }
+}
+
+// Number of source streams an op reads
+inline unsigned numSources( EW_OP op ) {
+  return op == EW_OP::SCALE ? 1 : op == EW_OP::SELECT ? 3 : 2;
+}
+
+inline unsigned elemBytes( EW_TYPE t ) {
+  switch( t ) {
+  case EW_TYPE::I8:
+  case EW_TYPE::U8: return 1;
+  case EW_TYPE::I16:
+  case EW_TYPE::U16: return 2;
+  case EW_TYPE::I32:
+  case EW_TYPE::U32:
+  case EW_TYPE::F32: return 4;
+  default: return 8;
+  }
+}
+
+// Pool one embedding row into acc. I8 rows are dequantized as scale * q + bias.
+template<typename T>
+void poolRow( const T* __restrict r, float scale, float bias, size_t dim, float* __restrict acc ) {
+  if constexpr( std::is_same_v<T, float> ) {
+    PIM_SIMD for( size_t j = 0; j < dim; j++ ) acc[j] += r[j];
+  } else {
+    PIM_SIMD for( size_t j = 0; j < dim; j++ ) acc[j] += scale * float( r[j] ) + bias;
+  }
+}
+
+// Delta + bit-pack codec, see CODEC_BLOCK_WORDS in pimdef.h
+inline bool codecHeaderValid( uint64_t header ) {
+  uint64_t w = header & 0xff;
+  uint64_t n = ( header >> 8 ) & 0xff;
+  return w <= 64 && n >= 1 && n <= CODEC_BLOCK_WORDS && ( header >> 16 ) == 0;
+}
+
+inline uint64_t codecBlockBytes( uint64_t header ) {
+  uint64_t w = header & 0xff;
+  uint64_t n = ( header >> 8 ) & 0xff;
+  return 16 + ( ( n - 1 ) * w + 63 ) / 64 * 8;
+}
+
+// Append the coded block of n words to out
+template<typename V>
+void encodeBlock( const uint64_t* x, size_t n, V& out ) {
+  assert( n >= 1 && n <= CODEC_BLOCK_WORDS );
+  uint64_t z[CODEC_BLOCK_WORDS];
+  uint64_t bits = 0;
+  PIM_SIMD_REDUCE( |, bits ) for( size_t i = 1; i < n; i++ ) {
+    uint64_t d = x[i] - x[i - 1];
+    z[i]       = ( d << 1 ) ^ uint64_t( int64_t( d ) >> 63 );
+    bits |= z[i];
+  }
+  unsigned w         = bits ? 64 - __builtin_clzll( bits ) : 0;
+  uint64_t header[2] = { w | ( uint64_t( n ) << 8 ), x[0] };
+  size_t   off       = out.size();
+  out.resize( off + codecBlockBytes( header[0] ) );
+  std::memcpy( out.data() + off, header, sizeof( header ) );
+  uint64_t packed[CODEC_BLOCK_WORDS] = {};
+  for( size_t i = 1, bit = 0; i < n; i++, bit += w ) {
+    size_t   word  = bit / 64;
+    unsigned shift = bit % 64;
+    packed[word] |= z[i] << shift;
+    if( shift + w > 64 )
+      packed[word + 1] |= z[i] >> ( 64 - shift );
+  }
+  std::memcpy( out.data() + off + sizeof( header ), packed, out.size() - off - sizeof( header ) );
+}
+
+// Append the words of the complete block at in to out
+template<typename V>
+void decodeBlock( const uint8_t* in, V& out ) {
+  uint64_t header[2];
+  std::memcpy( header, in, sizeof( header ) );
+  unsigned w = header[0] & 0xff;
+  size_t   n = ( header[0] >> 8 ) & 0xff;
+  uint64_t packed[CODEC_BLOCK_WORDS + 1] = {};
+  std::memcpy( packed, in + sizeof( header ), codecBlockBytes( header[0] ) - sizeof( header ) );
+  uint64_t mask = w == 64 ? ~0ull : ( 1ull << w ) - 1;
+  uint64_t x[CODEC_BLOCK_WORDS];
+  x[0] = header[1];
+  for( size_t i = 1, bit = 0; i < n; i++, bit += w ) {
+    size_t   word  = bit / 64;
+    unsigned shift = bit % 64;
+    uint64_t z     = packed[word] >> shift;
+    if( shift + w > 64 )
+      z |= packed[word + 1] << ( 64 - shift );
+    z &= mask;
+    x[i] = x[i - 1] + ( ( z >> 1 ) ^ ( 0 - ( z & 1 ) ) );
+  }
+  size_t off = out.size();
+  out.resize( off + n * sizeof( uint64_t ) );
+  std::memcpy( out.data() + off, x, n * sizeof( uint64_t ) );
+}
+
+// New value of a near-memory atomic. T is the signed integer of the operand
+// width and UMIN/UMAX compare its unsigned twin.
+template<typename T>
+inline T atomicApply( ATOMIC_OP op, T old, T v, T cmp ) {
+  using U = std::make_unsigned_t<T>;
+  switch( op ) {
+  case ATOMIC_OP::ADD: return T( U( old ) + U( v ) );
+  case ATOMIC_OP::MIN: return v < old ? v : old;
+  case ATOMIC_OP::MAX: return v > old ? v : old;
+  case ATOMIC_OP::UMIN: return U( v ) < U( old ) ? v : old;
+  case ATOMIC_OP::UMAX: return U( v ) > U( old ) ? v : old;
+  case ATOMIC_OP::AND: return T( old & v );
+  case ATOMIC_OP::OR: return T( old | v );
+  case ATOMIC_OP::XOR: return T( old ^ v );
+  case ATOMIC_OP::SWAP: return v;
+  case ATOMIC_OP::CAS: return old == cmp ? v : old;
+  }
+  return old;
+}
+
+// Fold sources 1..n-1 of a bitmap op into buffer 0 a word at a time and
+// return the popcount of the result
+template<typename B>
+uint64_t bitmapOp( BITMAP_OP op, B& bufs, unsigned n ) {
+  uint64_t* a     = elems<uint64_t>( bufs[0] );
+  size_t    words = bufs[0].size() / sizeof( uint64_t );
+  for( unsigned s = 1; s < n; s++ ) {
+    const uint64_t* b = elems<uint64_t>( bufs[s] );
+    switch( op ) {
+    case BITMAP_OP::AND: PIM_SIMD for( size_t i = 0; i < words; i++ ) a[i] &= b[i]; break;
+    case BITMAP_OP::OR: PIM_SIMD for( size_t i = 0; i < words; i++ ) a[i] |= b[i]; break;
+    case BITMAP_OP::XOR: PIM_SIMD for( size_t i = 0; i < words; i++ ) a[i] ^= b[i]; break;
+    case BITMAP_OP::ANDNOT: PIM_SIMD for( size_t i = 0; i < words; i++ ) a[i] &= ~b[i]; break;
+    }
+  }
+  uint64_t count = 0;
+  PIM_SIMD_REDUCE( +, count ) for( size_t i = 0; i < words; i++ ) count += __builtin_popcountll( a[i] );
+  return count;
+}
+
+// n interior outputs of a stencil row. x, north and south point at the
+// input above each output, and x[-1], x[n] are the west and east halo.
+// north and south are null for POINT3.
+template<typename T>
+void stencilRow( const T* k, const T* x, const T* north, const T* south, T* y, size_t n ) {
+  if( !north ) {
+    PIM_SIMD for( size_t i = 0; i < n; i++ ) y[i] = k[0] * x[i] + k[1] * x[i - 1] + k[2] * x[i + 1];
+    return;
+  }
+  PIM_SIMD for( size_t i = 0; i < n; i++ ) {
+    y[i] = k[0] * x[i] + k[1] * x[i - 1] + k[2] * x[i + 1] + k[3] * north[i] + k[4] * south[i];
+  }
+}
+
+// Slicing-by-8 tables for the reflected CRC-32C polynomial
+struct Crc32cTables {
+  uint32_t t[8][256];
+  Crc32cTables() {
+    for( uint32_t i = 0; i < 256; i++ ) {
+      uint32_t c = i;
+      for( int k = 0; k < 8; k++ )
+        c = ( c >> 1 ) ^ ( 0x82f63b78u & ( 0 - ( c & 1 ) ) );
+      t[0][i] = c;
+    }
+    for( uint32_t i = 0; i < 256; i++ )
+      for( int k = 1; k < 8; k++ )
+        t[k][i] = ( t[k - 1][i] >> 8 ) ^ t[0][t[k - 1][i] & 0xff];
+  }
+};
+
+inline const Crc32cTables& crc32cTables() {
+  static const Crc32cTables tables;
+  return tables;
+}
+
+// Checksum carried across chunks, see CSUM_ALG. Chunks may split the input
+// anywhere, and the digest is the same as for one contiguous buffer.
+class Hasher {
+public:
+  Hasher( CSUM_ALG alg = CSUM_ALG::CRC32C, uint64_t seed = 0 ) { reset( alg, seed ); }
+
+  void reset( CSUM_ALG a, uint64_t s ) {
+    alg   = a;
+    seed  = s;
+    crc   = ~uint32_t( s );
+    total = 0;
+    fill  = 0;
+    v[0]  = s + P1 + P2;
+    v[1]  = s + P2;
+    v[2]  = s;
+    v[3]  = s - P1;
+  }
+
+  void update( const uint8_t* p, size_t n ) {
+    total += n;
+    if( alg == CSUM_ALG::CRC32C ) {
+      crc32c( p, n );
+      return;
+    }
+    // Top up a partial stripe, then take whole 32-byte stripes in place
+    if( fill ) {
+      size_t k = std::min( n, sizeof( stripe ) - fill );
+      std::memcpy( stripe + fill, p, k );
+      fill += k;
+      p += k;
+      n -= k;
+      if( fill < sizeof( stripe ) )
+        return;
+      consume( stripe );
+      fill = 0;
+    }
+    for( ; n >= sizeof( stripe ); p += sizeof( stripe ), n -= sizeof( stripe ) )
+      consume( p );
+    std::memcpy( stripe, p, n );
+    fill = n;
+  }
+
+  uint64_t digest() const {
+    if( alg == CSUM_ALG::CRC32C )
+      return uint32_t( ~crc );
+    uint64_t h;
+    if( total >= sizeof( stripe ) ) {
+      h = rotl( v[0], 1 ) + rotl( v[1], 7 ) + rotl( v[2], 12 ) + rotl( v[3], 18 );
+      for( uint64_t x : v )
+        h = ( h ^ round( 0, x ) ) * P1 + P4;
+    } else {
+      h = seed + P5;
+    }
+    h += total;
+    size_t i = 0;
+    for( ; i + 8 <= fill; i += 8 )
+      h = rotl( h ^ round( 0, load<uint64_t>( stripe + i ) ), 27 ) * P1 + P4;
+    if( i + 4 <= fill ) {
+      h = rotl( h ^ ( load<uint32_t>( stripe + i ) * P1 ), 23 ) * P2 + P3;
+      i += 4;
+    }
+    for( ; i < fill; i++ )
+      h = rotl( h ^ ( stripe[i] * P5 ), 11 ) * P1;
+    h ^= h >> 33;
+    h *= P2;
+    h ^= h >> 29;
+    h *= P3;
+    return h ^ ( h >> 32 );
+  }
+
+private:
+  static constexpr uint64_t P1 = 0x9e3779b185ebca87ull;
+  static constexpr uint64_t P2 = 0xc2b2ae3d27d4eb4full;
+  static constexpr uint64_t P3 = 0x165667b19e3779f9ull;
+  static constexpr uint64_t P4 = 0x85ebca77c2b2ae63ull;
+  static constexpr uint64_t P5 = 0x27d4eb2f165667c5ull;
+
+  CSUM_ALG alg;
+  uint64_t seed;
+  uint32_t crc;
+  uint64_t total;  // bytes hashed
+  uint64_t v[4];   // XXH64 lanes
+  uint8_t  stripe[32];
+  size_t   fill;  // bytes of a partial stripe
+
+  template<typename T>
+  static T load( const uint8_t* p ) {
+    T x;
+    std::memcpy( &x, p, sizeof( T ) );
+    return x;
+  }
+
+  static uint64_t rotl( uint64_t x, unsigned r ) { return ( x << r ) | ( x >> ( 64 - r ) ); }
+
+  static uint64_t round( uint64_t acc, uint64_t x ) { return rotl( acc + x * P2, 31 ) * P1; }
+
+  void consume( const uint8_t* p ) {
+    for( int l = 0; l < 4; l++ )
+      v[l] = round( v[l], load<uint64_t>( p + 8 * l ) );
+  }
+
+  // Eight bytes per table step, then the tail a byte at a time
+  void crc32c( const uint8_t* p, size_t n ) {
+    const auto& t = crc32cTables().t;
+    for( ; n >= 8; p += 8, n -= 8 ) {
+      uint64_t x = load<uint64_t>( p ) ^ crc;
+      crc        = t[7][x & 0xff] ^ t[6][( x >> 8 ) & 0xff] ^ t[5][( x >> 16 ) & 0xff] ^ t[4][( x >> 24 ) & 0xff] ^
+            t[3][( x >> 32 ) & 0xff] ^ t[2][( x >> 40 ) & 0xff] ^ t[1][( x >> 48 ) & 0xff] ^ t[0][x >> 56];
+    }
+    for( ; n; p++, n-- )
+      crc = ( crc >> 8 ) ^ t[0][( crc ^ *p ) & 0xff];
+  }
+};
+
+}  // namespace SST::PIM::kernels
+
+#endif  //_SST_PIMBACKEND_TCL_PIM_KERNELS_
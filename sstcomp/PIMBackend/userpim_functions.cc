@@ -5,81 +5,2404 @@
 // See LICENSE in the top level directory for licensing details
 //
 
+#include <algorithm>
+
 #include "userpim_functions.h"
+#include "tclpim_kernels.h"
 
 namespace SST::PIM {
 
-MulVecByScalar::MulVecByScalar( TCLPIM* p ) : FSM( p ) {};
+HeldLines::HeldLines( TCLPIM* p ) : parent( p ) {}
 
-void MulVecByScalar::start( uint64_t params[NUM_FUNC_PARAMS] ) {
-  uint64_t numBytes = params[3];
-  if( numBytes == 0 )
+HeldLines::Line* HeldLines::find( uint64_t addr ) {
+  auto it = lines.find( addr );
+  return it == lines.end() ? nullptr : &it->second;
+}
+
+HeldLines::Line& HeldLines::hold( uint64_t addr, uint64_t bytes ) {
+  assert( !lines.count( addr ) );
+  Line& l = lines[addr];
+  l.data.assign( bytes, 0 );
+  return l;
+}
+
+void HeldLines::changed( uint64_t addr, Line& l ) {
+  if( !l.valid || l.queued )
     return;
-  assert((numBytes%8)==0);
-  this->dst    = params[0];
-  this->src    = params[1];
-  this->scalar = params[2];
-  total_words  = numBytes/8;
-  word_counter = numBytes/8;
-  dma_state    = DMA_STATE::READ;
+  l.queued = true;
+  if( !l.writing )
+    toWrite.push_back( addr );
+}
+
+void HeldLines::release( uint64_t addr ) {
+  const Line& l = lines.at( addr );
+  if( l.valid && !l.queued && !l.writing )
+    lines.erase( addr );
+}
+
+void HeldLines::writeBack( unsigned otherWrites ) {
+  if( toWrite.empty() || writesInFlight + otherWrites >= parent->getConfig().dmaMaxWrites )
+    return;
+  uint64_t addr = toWrite.front();
+  Line&    l    = lines.at( addr );
+  toWrite.pop_front();
+  l.queued  = false;
+  l.writing = true;
+  MemEventBase::dataVec d( l.data );
+  writesInFlight++;
+  parent->m_issueDRAMRequest( addr, &d, true, [this, addr]( const MemEventBase::dataVec& ) {
+    writesInFlight--;
+    Line& wl   = lines.at( addr );
+    wl.writing = false;
+    if( wl.queued )
+      toWrite.push_back( addr );
+    else
+      release( addr );
+  } );
+}
+
+ElementWise::ElementWise( TCLPIM* p ) : FSM( p ), dma( p ) {};
+
+// Param 0: Destination Address
+// Param 1: Source A Address
+// Param 2: Source B Address (unused by SCALE)
+// Param 3: Source C Address (SELECT masks)
+// Param 4: ewCtrl( EW_OP, EW_TYPE )
+// Param 5: alpha (SCALE, AXPY)
+// Param 6: Number of Bytes ( must by divisible by 8 )
+
+void ElementWise::start( uint64_t params[NUM_FUNC_PARAMS] ) {
+  uint64_t dst      = params[0];
+  uint64_t ctrl     = params[4];
+  uint64_t alpha    = params[5];
+  uint64_t numBytes = params[6];
+  EW_OP    op       = static_cast<EW_OP>( ctrl & 0xff );
+  EW_TYPE  type     = static_cast<EW_TYPE>( ( ctrl >> 8 ) & 0xff );
+  if( op > EW_OP::SELECT || type > EW_TYPE::F64 )
+    parent->output->fatal( CALL_INFO, -1, "ElementWise: bad control word 0x%" PRIx64 "\n", ctrl );
+  if( ( numBytes % 8 ) != 0 )
+    parent->output->fatal( CALL_INFO, -1, "ElementWise: size %" PRId64 " is not a multiple of 8\n", numBytes );
+
+  std::vector<uint64_t> srcs( params + 1, params + 1 + kernels::numSources( op ) );
+  DMAEngine::Transform  xform;
+  kernels::dispatchType( type, [&]( auto tag ) {
+    using T = decltype( tag );
+    xform   = [op, alpha]( DMAEngine::Buffers& b ) { kernels::elementWise<T>( op, alpha, b ); };
+  } );
   parent->output->verbose(
-    CALL_INFO, 3, 0, 
-    "MulVecByScalar: dst=0x%" PRIx64 " src=0x%" PRIx64 "scalar=%" PRId64 " total_words=%" PRId64 "\n", 
-    dst, src, scalar, total_words);
+    CALL_INFO, 3, 0, "ElementWise: op=%d type=%d dst=0x%" PRIx64 " srcA=0x%" PRIx64 " bytes=%" PRId64 "\n",
+    static_cast<int>( op ), static_cast<int>( type ), dst, params[1], numBytes
+  );
+  dma.start( dst, srcs, numBytes, xform );
 }
 
-bool MulVecByScalar::clock() {
-#if 1
-  unsigned words = word_counter >= 64 ? 64 : word_counter;
-#else
-  unsigned words = 1;
-#endif
-  unsigned bytes = words * sizeof( uint64_t );
-  //if (parent->buffer.size() != bytes)
-  parent->buffer.resize( bytes );
-  const bool WRITE = true;
-  const bool READ  = false;
-  if( dma_state == DMA_STATE::READ ) {
-    parent->m_issueDRAMRequest( src, &parent->buffer, READ, [this]( const MemEventBase::dataVec& d ) {
-      assert( parent->buffer.size() == d.size() );
-      // TODO use SRAM to save intermediate data
-      // TODO better utilities for manage the SST payload
-      // For now multiply every dword loaded by the scalar (messy)
-      for( size_t i = 0; i < d.size(); i+=8 ) {
-        uint64_t data = 0;
-        uint8_t* p = (uint8_t*)(&data);
-        for ( int j=0; j<8; j++) {
-          p[j] = d[i+j];
-        }
-        data = scalar*data;
-        for (int j=0;j<8;j++) {
-          parent->buffer[i+j] = p[j];
-        }
+bool ElementWise::clock() {
+  return dma.clock();
+}
+
+Reduce::Reduce( TCLPIM* p ) : FSM( p ), dma( p ) {};
+
+// Param 0: Result Address (SRAM)
+// Param 1: Source A Address
+// Param 2: Source B Address (DOT)
+// Param 3: redCtrl( RED_OP, EW_TYPE )
+// Param 4: Number of Bytes ( must by divisible by 8 )
+
+void Reduce::start( uint64_t params[NUM_FUNC_PARAMS] ) {
+  result            = params[0];
+  uint64_t ctrl     = params[3];
+  uint64_t numBytes = params[4];
+  op                = static_cast<RED_OP>( ctrl & 0xff );
+  EW_TYPE type      = static_cast<EW_TYPE>( ( ctrl >> 8 ) & 0xff );
+  if( op > RED_OP::DOT || type > EW_TYPE::F64 )
+    parent->output->fatal( CALL_INFO, -1, "Reduce: bad control word 0x%" PRIx64 "\n", ctrl );
+  if( ( numBytes % 8 ) != 0 )
+    parent->output->fatal( CALL_INFO, -1, "Reduce: size %" PRId64 " is not a multiple of 8\n", numBytes );
+  auto inf = parent->getDecodeInfo( result );
+  if( !inf.isIO || inf.pimAccType != PIM_ACCESS_TYPE::SRAM )
+    parent->output->fatal( CALL_INFO, -1, "Reduce: result address 0x%" PRIx64 " must be SRAM\n", result );
+
+  value = 0;
+  index = ~0ull;
+  std::vector<uint64_t> srcs( params + 1, params + 1 + ( op == RED_OP::DOT ? 2 : 1 ) );
+  DMAEngine::Transform  xform;
+  kernels::dispatchType( type, [&]( auto tag ) {
+    using T = decltype( tag );
+    xform   = [this, r = kernels::Reducer<T>( op )]( DMAEngine::Buffers& b ) mutable {
+      r.chunk( b );
+      value = r.value();
+      index = r.index();
+    };
+  } );
+  parent->output->verbose(
+    CALL_INFO, 3, 0, "Reduce: op=%d type=%d result=0x%" PRIx64 " src=0x%" PRIx64 " bytes=%" PRId64 "\n",
+    static_cast<int>( op ), static_cast<int>( type ), result, params[1], numBytes
+  );
+  // Chunks fold in address order so floating point results are reproducible
+  dma.start( DMAEngine::NO_DST, srcs, numBytes, xform, true );
+}
+
+bool Reduce::clock() {
+  if( !dma.clock() )
+    return false;
+  uint64_t              words[2] = { value, index };
+  MemEventBase::dataVec d( op == RED_OP::ARGMAX ? 16 : 8 );
+  std::memcpy( d.data(), words, d.size() );
+  parent->write( result, d.size(), &d );
+  return true;
+}
+
+Scan::Scan( TCLPIM* p ) : FSM( p ), dma( p ) {};
+
+// Param 0: Destination Address
+// Param 1: Source Address
+// Param 2: redCtrl( RED_OP, EW_TYPE, exclusive )
+// Param 3: Number of Bytes ( must by divisible by 8 )
+
+void Scan::start( uint64_t params[NUM_FUNC_PARAMS] ) {
+  uint64_t ctrl      = params[2];
+  uint64_t numBytes  = params[3];
+  RED_OP   op        = static_cast<RED_OP>( ctrl & 0xff );
+  EW_TYPE  type      = static_cast<EW_TYPE>( ( ctrl >> 8 ) & 0xff );
+  bool     exclusive = ( ctrl >> 16 ) & 1;
+  if( op > RED_OP::MAX || type > EW_TYPE::F64 )
+    parent->output->fatal( CALL_INFO, -1, "Scan: bad control word 0x%" PRIx64 "\n", ctrl );
+  if( ( numBytes % 8 ) != 0 )
+    parent->output->fatal( CALL_INFO, -1, "Scan: size %" PRId64 " is not a multiple of 8\n", numBytes );
+
+  DMAEngine::Transform xform;
+  kernels::dispatchType( type, [&]( auto tag ) {
+    using T = decltype( tag );
+    xform   = [s = kernels::Scanner<T>( op, exclusive )]( DMAEngine::Buffers& b ) mutable { s.chunk( b ); };
+  } );
+  parent->output->verbose(
+    CALL_INFO, 3, 0, "Scan: op=%d type=%d exclusive=%d dst=0x%" PRIx64 " src=0x%" PRIx64 " bytes=%" PRId64 "\n",
+    static_cast<int>( op ), static_cast<int>( type ), exclusive, params[0], params[1], numBytes
+  );
+  dma.start( params[0], { params[1] }, numBytes, xform, true );
+}
+
+bool Scan::clock() {
+  return dma.clock();
+}
+
+PointerChase::PointerChase( TCLPIM* p ) : FSM( p ) {};
+
+// Param 0: Result Address (SRAM)
+// Param 1: Start Node Address
+// Param 2: Next Pointer Offset
+// Param 3: Maximum Hops ( 0 follows until a null pointer )
+// Param 4: Key Offset
+// Param 5: Key
+// Param 6: chaseCtrl( match, payload bytes )
+// Param 7: Payload Offset
+
+void PointerChase::start( uint64_t params[NUM_FUNC_PARAMS] ) {
+  result       = params[0];
+  node         = params[1];
+  nextOff      = params[2];
+  maxHops      = params[3];
+  keyOff       = params[4];
+  key          = params[5];
+  match        = params[6] & CHASE_MATCH;
+  payloadBytes = ( params[6] >> 8 ) & 0xff;
+  payloadOff   = params[7];
+  hops         = 0;
+  auto inf     = parent->getDecodeInfo( result );
+  if( !inf.isIO || inf.pimAccType != PIM_ACCESS_TYPE::SRAM )
+    parent->output->fatal( CALL_INFO, -1, "PointerChase: result address 0x%" PRIx64 " must be SRAM\n", result );
+
+  // One read per hop covers the next pointer, the key and the payload
+  uint64_t hi = nextOff + 8;
+  spanLo      = nextOff;
+  if( match ) {
+    spanLo = std::min( spanLo, keyOff );
+    hi     = std::max( hi, keyOff + 8 );
+  }
+  if( payloadBytes ) {
+    spanLo = std::min( spanLo, payloadOff );
+    hi     = std::max( hi, payloadOff + payloadBytes );
+  }
+  spanBytes = hi - spanLo;
+  parent->output->verbose(
+    CALL_INFO, 3, 0, "PointerChase: start=0x%" PRIx64 " next_off=%" PRId64 " max_hops=%" PRId64 " match=%d key=0x%" PRIx64 "\n",
+    node, nextOff, maxHops, match, key
+  );
+  state = STATE::FETCH;
+  if( node == 0 )
+    finish( 0 );
+}
+
+bool PointerChase::clock() {
+  if( state == STATE::FETCH )
+    fetch();
+  if( state != STATE::DONE )
+    return false;
+  state = STATE::IDLE;
+  return true;
+}
+
+void PointerChase::fetch() {
+  uint64_t addr = node + spanLo;
+  auto     inf  = parent->getDecodeInfo( addr );
+  if( inf.isIO && inf.pimAccType != PIM_ACCESS_TYPE::SRAM )
+    parent->output->fatal( CALL_INFO, -1, "PointerChase: node 0x%" PRIx64 " must be SRAM or DRAM\n", node );
+  buffer.resize( spanBytes );
+  if( inf.isIO ) {
+    parent->read( addr, spanBytes, buffer );
+    visit();
+    return;
+  }
+  state = STATE::WAIT;
+  parent->m_issueDRAMRequest( addr, &buffer, false, [this]( const MemEventBase::dataVec& d ) {
+    assert( state == STATE::WAIT && d.size() == buffer.size() );
+    buffer = d;
+    visit();
+  } );
+}
+
+uint64_t PointerChase::field( uint64_t off ) {
+  uint64_t v;
+  std::memcpy( &v, &buffer[off - spanLo], sizeof( v ) );
+  return v;
+}
+
+void PointerChase::visit() {
+  parent->output->verbose( CALL_INFO, 4, 0, "PointerChase: hop=%" PRId64 " node=0x%" PRIx64 "\n", hops, node );
+  if( match && field( keyOff ) == key ) {
+    finish( node );
+    return;
+  }
+  uint64_t next = field( nextOff );
+  if( next == 0 || ( maxHops && hops == maxHops ) ) {
+    finish( match ? 0 : node );
+    return;
+  }
+  hops++;
+  node  = next;
+  state = STATE::FETCH;
+}
+
+void PointerChase::finish( uint64_t found ) {
+  MemEventBase::dataVec d( 16 + payloadBytes, 0 );
+  std::memcpy( &d[0], &found, sizeof( found ) );
+  std::memcpy( &d[8], &hops, sizeof( hops ) );
+  if( found && payloadBytes )
+    std::memcpy( &d[16], &buffer[payloadOff - spanLo], payloadBytes );
+  parent->write( result, d.size(), &d );
+  state = STATE::DONE;
+}
+
+HashProbe::HashProbe( TCLPIM* p ) : FSM( p ) {
+  probes.resize( parent->getConfig().hashMaxProbes );
+};
+
+// Param 0: Values Address (SRAM)
+// Param 1: Keys Address (SRAM)
+// Param 2: Number of Keys
+// Param 3: Table Address
+// Param 4: Number of Buckets ( power of 2 )
+// Param 5: HASH_MODE
+// Param 6: Empty Key ( OPEN )
+// Param 7: Miss Value
+
+void HashProbe::start( uint64_t params[NUM_FUNC_PARAMS] ) {
+  values     = params[0];
+  keys       = params[1];
+  numKeys    = params[2];
+  table      = params[3];
+  numBuckets = params[4];
+  mode       = static_cast<HASH_MODE>( params[5] );
+  emptyKey   = params[6];
+  missValue  = params[7];
+  nextKey    = 0;
+  nextIssue  = 0;
+  if( mode != HASH_MODE::OPEN && mode != HASH_MODE::CHAINED )
+    parent->output->fatal( CALL_INFO, -1, "HashProbe: bad mode %" PRId64 "\n", params[5] );
+  if( numBuckets == 0 || ( numBuckets & ( numBuckets - 1 ) ) != 0 )
+    parent->output->fatal( CALL_INFO, -1, "HashProbe: %" PRId64 " buckets is not a power of 2\n", numBuckets );
+  for( uint64_t a : { values, keys } ) {
+    auto inf = parent->getDecodeInfo( a );
+    if( !inf.isIO || inf.pimAccType != PIM_ACCESS_TYPE::SRAM )
+      parent->output->fatal( CALL_INFO, -1, "HashProbe: keys and values must be in SRAM\n" );
+  }
+  for( auto& pr : probes )
+    assert( !pr.active );
+  parent->output->verbose(
+    CALL_INFO, 3, 0, "HashProbe: mode=%d keys=%" PRId64 " table=0x%" PRIx64 " buckets=%" PRId64 "\n",
+    static_cast<int>( mode ), numKeys, table, numBuckets
+  );
+}
+
+bool HashProbe::clock() {
+  // Keys come from SRAM, so every free probe can take one per cycle
+  bool busy = false;
+  for( auto& pr : probes ) {
+    if( !pr.active && nextKey < numKeys )
+      admit( pr );
+    busy = busy || pr.active;
+  }
+  if( !busy )
+    return true;
+
+  // One table read per cycle, round robin over the ready probes
+  for( unsigned n = 0; n < probes.size(); n++ ) {
+    unsigned pi = ( nextIssue + n ) % probes.size();
+    if( probes[pi].active && probes[pi].ready ) {
+      nextIssue = ( pi + 1 ) % probes.size();
+      issue( pi );
+      break;
+    }
+  }
+  return false;
+}
+
+void HashProbe::admit( Probe& pr ) {
+  MemEventBase::dataVec k( sizeof( uint64_t ) );
+  parent->read( keys + nextKey * sizeof( uint64_t ), k.size(), k );
+  pr.active = true;
+  pr.ready  = true;
+  pr.i      = nextKey++;
+  std::memcpy( &pr.key, k.data(), sizeof( pr.key ) );
+  pr.bucket = hashKey( pr.key ) & ( numBuckets - 1 );
+  pr.probes = 0;
+  pr.step   = STEP::BUCKET;
+  pr.addr   = table + pr.bucket * ( mode == HASH_MODE::OPEN ? 2 : 1 ) * sizeof( uint64_t );
+}
+
+void HashProbe::issue( unsigned pi ) {
+  Probe& pr = probes[pi];
+  // {key, value} bucket, bucket head pointer or {key, value, next} node
+  unsigned words = mode == HASH_MODE::OPEN ? 2 : pr.step == STEP::BUCKET ? 1 : 3;
+  pr.data.resize( words * sizeof( uint64_t ) );
+  pr.ready = false;
+  auto inf = parent->getDecodeInfo( pr.addr );
+  if( inf.isIO && inf.pimAccType != PIM_ACCESS_TYPE::SRAM )
+    parent->output->fatal( CALL_INFO, -1, "HashProbe: table address 0x%" PRIx64 " must be SRAM or DRAM\n", pr.addr );
+  if( inf.isIO ) {
+    parent->read( pr.addr, pr.data.size(), pr.data );
+    probed( pr );
+    return;
+  }
+  uint64_t i = pr.i;
+  parent->m_issueDRAMRequest( pr.addr, &pr.data, false, [this, pi, i]( const MemEventBase::dataVec& d ) {
+    Probe& rp = probes[pi];
+    assert( rp.active && rp.i == i && d.size() == rp.data.size() );
+    rp.data = d;
+    probed( rp );
+  } );
+}
+
+uint64_t HashProbe::word( const Probe& pr, unsigned w ) {
+  uint64_t v;
+  std::memcpy( &v, &pr.data[w * sizeof( uint64_t )], sizeof( v ) );
+  return v;
+}
+
+void HashProbe::probed( Probe& pr ) {
+  if( mode == HASH_MODE::OPEN ) {
+    uint64_t k = word( pr, 0 );
+    if( k == pr.key )
+      return finish( pr, word( pr, 1 ) );
+    if( k == emptyKey || ++pr.probes == numBuckets )
+      return finish( pr, missValue );
+    pr.bucket = ( pr.bucket + 1 ) & ( numBuckets - 1 );
+    pr.addr   = table + pr.bucket * 2 * sizeof( uint64_t );
+  } else if( pr.step == STEP::BUCKET ) {
+    if( word( pr, 0 ) == 0 )
+      return finish( pr, missValue );
+    pr.step = STEP::NODE;
+    pr.addr = word( pr, 0 );
+  } else {
+    if( word( pr, 0 ) == pr.key )
+      return finish( pr, word( pr, 1 ) );
+    if( word( pr, 2 ) == 0 )
+      return finish( pr, missValue );
+    pr.addr = word( pr, 2 );
+  }
+  pr.ready = true;
+}
+
+void HashProbe::finish( Probe& pr, uint64_t value ) {
+  MemEventBase::dataVec v( sizeof( value ) );
+  std::memcpy( v.data(), &value, sizeof( value ) );
+  parent->write( values + pr.i * sizeof( uint64_t ), v.size(), &v );
+  pr.active = false;
+}
+
+Sort::Sort( TCLPIM* p ) : FSM( p ), dma( p ), out( p ) {};
+
+// Param 0: Destination Address (DRAM)
+// Param 1: Source Address ( may alias dst or tmp )
+// Param 2: Temporary Address (DRAM, needed when count exceeds one tile)
+// Param 3: Number of Records
+// Param 4: sortCtrl( kv, SORT_NET )
+// Param 5: Tile Address (SRAM)
+// Param 6: Tile Bytes ( 0 runs to the end of SRAM )
+
+void Sort::start( uint64_t params[NUM_FUNC_PARAMS] ) {
+  dst                = params[0];
+  src                = params[1];
+  tmp                = params[2];
+  count              = params[3];
+  uint64_t ctrl      = params[4];
+  tile               = params[5];
+  uint64_t tileBytes = params[6];
+  net                = static_cast<SORT_NET>( ( ctrl >> 8 ) & 0xff );
+  recBytes           = ( ctrl & 1 ) ? 2 * sizeof( uint64_t ) : sizeof( uint64_t );
+  if( net > SORT_NET::RADIX || ( ctrl & ~0xff01ull ) != 0 )
+    parent->output->fatal( CALL_INFO, -1, "Sort: bad control word 0x%" PRIx64 "\n", ctrl );
+  auto inf = parent->getDecodeInfo( tile );
+  if( !inf.isIO || inf.pimAccType != PIM_ACCESS_TYPE::SRAM || tile >= SRAM_BASE + SRAM_SIZE )
+    parent->output->fatal( CALL_INFO, -1, "Sort: tile address 0x%" PRIx64 " must be SRAM\n", tile );
+  uint64_t sramLeft = SRAM_BASE + SRAM_SIZE - tile;
+  if( tileBytes == 0 )
+    tileBytes = sramLeft;
+  tileRecs = std::min( tileBytes, sramLeft ) / recBytes;
+  if( tileRecs == 0 || tileBytes > sramLeft )
+    parent->output->fatal( CALL_INFO, -1, "Sort: tile of %" PRId64 " bytes does not fit in SRAM\n", tileBytes );
+
+  // Each merge pass flips the buffer so the last one lands in dst
+  unsigned passes = 0;
+  for( uint64_t r = tileRecs; r < count; r *= 2 )
+    passes++;
+  for( uint64_t a : { dst, tmp } ) {
+    if( a == tmp && passes == 0 )
+      continue;
+    if( parent->getDecodeInfo( a ).isIO )
+      parent->output->fatal( CALL_INFO, -1, "Sort: dst and tmp must be DRAM\n" );
+  }
+  tileBase = ( passes % 2 ) ? tmp : dst;
+  runRecs  = tileRecs;
+  tileIdx  = 0;
+  parent->output->verbose(
+    CALL_INFO, 3, 0, "Sort: records=%" PRId64 " kv=%d net=%d tile_records=%" PRId64 " merge_passes=%u\n", count,
+    recBytes > sizeof( uint64_t ), static_cast<int>( net ), tileRecs, passes
+  );
+  phase = PHASE::IDLE;
+  if( count ) {
+    dma.start( tile, src, tileCount() * recBytes );
+    phase = PHASE::LOAD;
+  }
+}
+
+bool Sort::clock() {
+  switch( phase ) {
+  case PHASE::IDLE: return true;
+  case PHASE::LOAD:
+    if( dma.clock() ) {
+      sortTile();
+      phase = PHASE::SORT;
+    }
+    return false;
+  case PHASE::SORT:
+    if( stall ) {
+      stall--;
+      return false;
+    }
+    dma.start( tileBase + tileIdx * tileRecs * recBytes, tile, tileCount() * recBytes );
+    phase = PHASE::STORE;
+    return false;
+  case PHASE::STORE:
+    if( !dma.clock() )
+      return false;
+    if( ++tileIdx * tileRecs < count ) {
+      dma.start( tile, src + tileIdx * tileRecs * recBytes, tileCount() * recBytes );
+      phase = PHASE::LOAD;
+      return false;
+    }
+    if( runRecs >= count ) {
+      phase = PHASE::IDLE;
+      return true;
+    }
+    from     = tileBase;
+    to       = tileBase == dst ? tmp : dst;
+    pairBase = 0;
+    startPair();
+    phase = PHASE::MERGE;
+    return false;
+  case PHASE::MERGE:
+    if( !merge() )
+      return false;
+    if( pairBase + 2 * runRecs < count ) {
+      pairBase += 2 * runRecs;
+      startPair();
+      return false;
+    }
+    // The next pass reads what this one wrote
+    if( !out.done() )
+      return false;
+    runRecs *= 2;
+    if( runRecs >= count ) {
+      phase = PHASE::IDLE;
+      return true;
+    }
+    std::swap( from, to );
+    pairBase = 0;
+    startPair();
+    return false;
+  }
+  return false;
+}
+
+uint64_t Sort::tileCount() {
+  return std::min( tileRecs, count - tileIdx * tileRecs );
+}
+
+// Modeled latency of sorting n records with sortLanes compare-exchange units
+uint64_t Sort::networkCycles( uint64_t n ) {
+  uint64_t lanes = parent->getConfig().sortLanes;
+  if( n <= 1 )
+    return 0;
+  if( net == SORT_NET::RADIX ) {
+    // 8-bit digits, a counting and a scatter sweep per digit
+    return 8 * 2 * ( ( n + lanes - 1 ) / lanes );
+  }
+  // Bitonic network over n padded to a power of 2: lg(lg+1)/2 stages of m/2 comparators
+  uint64_t lg = 0;
+  while( ( 1ull << lg ) < n )
+    lg++;
+  uint64_t half = 1ull << ( lg - 1 );
+  return lg * ( lg + 1 ) / 2 * ( ( half + lanes - 1 ) / lanes );
+}
+
+namespace {
+struct KeyValue {
+  uint64_t key;
+  uint64_t value;
+};
+}  // namespace
+
+// Sort the staged tile in place in SRAM and start the modeled network delay
+void Sort::sortTile() {
+  uint64_t              n = tileCount();
+  MemEventBase::dataVec d( n * recBytes );
+  parent->read( tile, d.size(), d );
+  if( recBytes == sizeof( uint64_t ) ) {
+    std::vector<uint64_t> r( n );
+    std::memcpy( r.data(), d.data(), d.size() );
+    std::sort( r.begin(), r.end() );
+    std::memcpy( d.data(), r.data(), d.size() );
+  } else {
+    std::vector<KeyValue> r( n );
+    std::memcpy( r.data(), d.data(), d.size() );
+    std::stable_sort( r.begin(), r.end(), []( const KeyValue& a, const KeyValue& b ) { return a.key < b.key; } );
+    std::memcpy( d.data(), r.data(), d.size() );
+  }
+  parent->write( tile, d.size(), &d );
+  stall = networkCycles( n );
+  parent->output->verbose(
+    CALL_INFO, 4, 0, "Sort: tile=%" PRId64 " records=%" PRId64 " cycles=%" PRId64 "\n", tileIdx, n, stall
+  );
+}
+
+// Set up the inputs for runs starting at pairBase. A lone last run is copied.
+void Sort::startPair() {
+  uint64_t la = std::min( runRecs, count - pairBase );
+  uint64_t lb = std::min( runRecs, count - pairBase - la );
+  for( unsigned i = 0; i < 2; i++ ) {
+    assert( !in[i].pending );
+    in[i].addr = from + ( pairBase + ( i ? la : 0 ) ) * recBytes;
+    in[i].left = ( i ? lb : la ) * recBytes;
+    in[i].pos  = 0;
+    in[i].data.clear();
+  }
+  const TCLPIMConfig& cfg = parent->getConfig();
+  chunk                   = std::max<uint64_t>( recBytes, cfg.dmaChunkBytes - cfg.dmaChunkBytes % recBytes );
+  out.start( to + pairBase * recBytes, chunk );
+  parent->output->verbose(
+    CALL_INFO, 4, 0, "Sort: merge run=%" PRId64 " base=%" PRId64 " a=%" PRId64 " b=%" PRId64 "\n", runRecs, pairBase,
+    la, lb
+  );
+}
+
+// One cycle of the streaming merge. Returns true once the pair is written out.
+bool Sort::merge() {
+  const TCLPIMConfig& cfg = parent->getConfig();
+
+  // One read per cycle, for the input with the least staged
+  int pick = -1;
+  for( unsigned i = 0; i < 2; i++ ) {
+    const Input& r = in[i];
+    if( r.pending || r.left == 0 || r.data.size() - r.pos >= chunk )
+      continue;
+    if( pick < 0 || r.data.size() - r.pos < in[pick].data.size() - in[pick].pos )
+      pick = i;
+  }
+  if( pick >= 0 )
+    fetch( pick );
+
+  // Merge up to sortLanes records while both heads are known
+  for( unsigned k = 0; k < cfg.sortLanes; k++ ) {
+    bool done0 = drained( in[0] ), done1 = drained( in[1] );
+    if( done0 && done1 )
+      break;
+    if( ( !done0 && in[0].pos == in[0].data.size() ) || ( !done1 && in[1].pos == in[1].data.size() ) )
+      break;
+    Input& r = ( done1 || ( !done0 && key( in[0] ) <= key( in[1] ) ) ) ? in[0] : in[1];
+    out.data().insert( out.data().end(), r.data.begin() + r.pos, r.data.begin() + r.pos + recBytes );
+    r.pos += recBytes;
+  }
+
+  // Write whole chunks, and the tail once both runs are consumed
+  bool consumed = drained( in[0] ) && drained( in[1] );
+  out.flush( consumed );
+  return consumed && out.empty();
+}
+
+void Sort::fetch( unsigned i ) {
+  Input&                r = in[i];
+  MemEventBase::dataVec d( std::min( r.left, chunk ) );
+  r.pending = true;
+  parent->m_issueDRAMRequest( r.addr, &d, false, [this, i]( const MemEventBase::dataVec& v ) {
+    Input& fr = in[i];
+    assert( fr.pending );
+    fr.data.erase( fr.data.begin(), fr.data.begin() + fr.pos );
+    fr.pos = 0;
+    fr.data.insert( fr.data.end(), v.begin(), v.end() );
+    fr.pending = false;
+  } );
+  r.addr += d.size();
+  r.left -= d.size();
+}
+
+bool Sort::drained( const Input& r ) {
+  return !r.pending && r.left == 0 && r.pos == r.data.size();
+}
+
+uint64_t Sort::key( const Input& r ) {
+  uint64_t k;
+  std::memcpy( &k, &r.data[r.pos], sizeof( k ) );
+  return k;
+}
+
+Filter::Filter( TCLPIM* p ) : FSM( p ), dma( p ), out( p ) {};
+
+// Param 0: Destination Address
+// Param 1: Source Address
+// Param 2: Result Address (SRAM)
+// Param 3: filterCtrl( FILTER_OP, EW_TYPE, indices )
+// Param 4: Operand A
+// Param 5: Operand B ( RANGE, MASK )
+// Param 6: Number of Elements
+
+void Filter::start( uint64_t params[NUM_FUNC_PARAMS] ) {
+  uint64_t  dst     = params[0];
+  result            = params[2];
+  uint64_t  ctrl    = params[3];
+  uint64_t  a       = params[4];
+  uint64_t  b       = params[5];
+  uint64_t  n       = params[6];
+  FILTER_OP op      = static_cast<FILTER_OP>( ctrl & 0xff );
+  EW_TYPE   type    = static_cast<EW_TYPE>( ( ctrl >> 8 ) & 0xff );
+  bool      indices = ( ctrl & FILTER_INDICES ) != 0;
+  if( op > FILTER_OP::MASK || type > EW_TYPE::F64 || ( ctrl & ~( FILTER_INDICES | 0xffff ) ) != 0 )
+    parent->output->fatal( CALL_INFO, -1, "Filter: bad control word 0x%" PRIx64 "\n", ctrl );
+  auto inf = parent->getDecodeInfo( result );
+  if( !inf.isIO || inf.pimAccType != PIM_ACCESS_TYPE::SRAM )
+    parent->output->fatal( CALL_INFO, -1, "Filter: result address 0x%" PRIx64 " must be SRAM\n", result );
+  inf = parent->getDecodeInfo( dst );
+  if( inf.isIO && inf.pimAccType != PIM_ACCESS_TYPE::SRAM )
+    parent->output->fatal( CALL_INFO, -1, "Filter: destination must be SRAM or DRAM\n" );
+
+  matches = 0;
+  scanned = false;
+  assert( out.done() );
+  out.start( dst );
+  DMAEngine::Transform xform;
+  kernels::dispatchType( type, [&]( auto tag ) {
+    using T = decltype( tag );
+    xform   = [this, op, a, b, indices, first = uint64_t( 0 ), m = std::vector<uint8_t>()]( DMAEngine::Buffers& bufs ) mutable {
+      const T* x = kernels::elems<T>( bufs[0] );
+      size_t   k = bufs[0].size() / sizeof( T );
+      m.resize( k );
+      kernels::match<T>( op, kernels::fromBits<T>( a ), kernels::fromBits<T>( b ), x, m.data(), k );
+      matches += kernels::compact( x, m.data(), k, first, indices, out.data() );
+      first += k;
+    };
+  } );
+  parent->output->verbose(
+    CALL_INFO, 3, 0, "Filter: op=%d type=%d indices=%d dst=0x%" PRIx64 " src=0x%" PRIx64 " elements=%" PRId64 "\n",
+    static_cast<int>( op ), static_cast<int>( type ), indices, dst, params[1], n
+  );
+  // Chunks are compacted in source order so matches stay in order
+  dma.start( DMAEngine::NO_DST, { params[1] }, n * kernels::elemBytes( type ), xform, true );
+}
+
+bool Filter::clock() {
+  // Hold the scan while matches wait to drain. Index output can grow faster
+  // than one chunk per cycle.
+  if( !scanned && out.size() < 2 * parent->getConfig().dmaChunkBytes )
+    scanned = dma.clock();
+  out.flush( scanned );
+  if( !scanned || !out.done() )
+    return false;
+  MemEventBase::dataVec d( sizeof( matches ) );
+  std::memcpy( d.data(), &matches, sizeof( matches ) );
+  parent->write( result, d.size(), &d );
+  return true;
+}
+
+Histogram::Histogram( TCLPIM* p ) : FSM( p ), dma( p ) {
+  spills.resize( parent->getConfig().dmaMaxWrites );
+};
+
+namespace {
+// Fold b into the aggregate a
+uint64_t combine( HIST_OP op, uint64_t a, uint64_t b ) {
+  if( op != HIST_OP::FSUM )
+    return a + b;
+  double x, y;
+  std::memcpy( &x, &a, sizeof( x ) );
+  std::memcpy( &y, &b, sizeof( y ) );
+  x += y;
+  std::memcpy( &a, &x, sizeof( a ) );
+  return a;
+}
+}  // namespace
+
+// Param 0: Destination Address (DRAM, one word per bin)
+// Param 1: Keys Address
+// Param 2: Values Address ( SUM, FSUM )
+// Param 3: Number of Records
+// Param 4: Number of Bins
+// Param 5: histCtrl( HIST_OP, shift )
+// Param 6: Bin Address (SRAM)
+// Param 7: Bin Bytes ( 0 runs to the end of SRAM )
+
+void Histogram::start( uint64_t params[NUM_FUNC_PARAMS] ) {
+  dst               = params[0];
+  keys              = params[1];
+  values            = params[2];
+  count             = params[3];
+  bins              = params[4];
+  uint64_t ctrl     = params[5];
+  window            = params[6];
+  uint64_t winBytes = params[7];
+  op                = static_cast<HIST_OP>( ctrl & 0xff );
+  shift             = ( ctrl >> 8 ) & 0xff;
+  if( op > HIST_OP::FSUM || shift > 63 || ( ctrl & ~0xffffull ) != 0 )
+    parent->output->fatal( CALL_INFO, -1, "Histogram: bad control word 0x%" PRIx64 "\n", ctrl );
+  if( bins == 0 )
+    parent->output->fatal( CALL_INFO, -1, "Histogram: needs at least one bin\n" );
+  if( parent->getDecodeInfo( dst ).isIO )
+    parent->output->fatal( CALL_INFO, -1, "Histogram: destination 0x%" PRIx64 " must be DRAM\n", dst );
+  auto inf = parent->getDecodeInfo( window );
+  if( !inf.isIO || inf.pimAccType != PIM_ACCESS_TYPE::SRAM || window >= SRAM_BASE + SRAM_SIZE )
+    parent->output->fatal( CALL_INFO, -1, "Histogram: bin address 0x%" PRIx64 " must be SRAM\n", window );
+  uint64_t sramLeft = SRAM_BASE + SRAM_SIZE - window;
+  if( winBytes == 0 )
+    winBytes = sramLeft;
+  if( winBytes > sramLeft )
+    parent->output->fatal( CALL_INFO, -1, "Histogram: %" PRId64 " bin bytes do not fit in SRAM\n", winBytes );
+
+  const TCLPIMConfig& cfg   = parent->getConfig();
+  uint64_t            words = winBytes / sizeof( uint64_t );
+  resident                  = bins <= words;
+  lineBins                  = cfg.gsBurstBytes / sizeof( uint64_t );
+  tags.clear();
+  if( !resident ) {
+    if( words < lineBins )
+      parent->output->fatal( CALL_INFO, -1, "Histogram: %" PRId64 " bin bytes hold no bin line\n", winBytes );
+    tags.assign( words / lineBins, NO_LINE );
+    words = tags.size() * lineBins;
+  } else {
+    words = bins;
+  }
+  MemEventBase::dataVec z( words * sizeof( uint64_t ), 0 );
+  parent->write( window, z.size(), &z );
+  for( auto& sp : spills )
+    assert( sp.state == SPILL_STATE::FREE );
+  stagedKeys.clear();
+  stagedValues.clear();
+  head      = 0;
+  flushSlot = 0;
+  parent->output->verbose(
+    CALL_INFO, 3, 0, "Histogram: op=%d records=%" PRId64 " bins=%" PRId64 " shift=%u resident=%d slots=%zu\n",
+    static_cast<int>( op ), count, bins, shift, resident, tags.size()
+  );
+
+  if( resident ) {
+    startScan();
+    return;
+  }
+  // Spills add into dst, so it starts cleared
+  zeros.assign( cfg.dmaChunkBytes, 0 );
+  std::vector<DMAEngine::Segment> segs;
+  for( uint64_t off = 0; off < bins * sizeof( uint64_t ); off += cfg.dmaChunkBytes ) {
+    DMAEngine::Segment seg;
+    seg.dst   = dst + off;
+    seg.local = zeros.data();
+    seg.bytes = std::min<uint64_t>( cfg.dmaChunkBytes, bins * sizeof( uint64_t ) - off );
+    segs.push_back( seg );
+  }
+  dma.start( segs );
+  phase = PHASE::CLEAR;
+}
+
+void Histogram::startScan() {
+  std::vector<uint64_t> srcs{ keys };
+  if( op != HIST_OP::COUNT )
+    srcs.push_back( values );
+  dma.start(
+    DMAEngine::NO_DST, srcs, count * sizeof( uint64_t ),
+    [this]( DMAEngine::Buffers& b ) {
+      const uint64_t* k = kernels::elems<uint64_t>( b[0] );
+      size_t          n = b[0].size() / sizeof( uint64_t );
+      stagedKeys.insert( stagedKeys.end(), k, k + n );
+      if( op != HIST_OP::COUNT ) {
+        const uint64_t* v = kernels::elems<uint64_t>( b[1] );
+        stagedValues.insert( stagedValues.end(), v, v + n );
       }
-      dma_state = DMA_STATE::WRITE;
+    },
+    true
+  );
+  phase = PHASE::SCAN;
+}
+
+bool Histogram::clock() {
+  const TCLPIMConfig& cfg = parent->getConfig();
+  issueSpills();
+  switch( phase ) {
+  case PHASE::IDLE: return true;
+  case PHASE::CLEAR:
+    if( dma.clock() )
+      startScan();
+    return false;
+  case PHASE::SCAN: {
+    // Stage at most two chunks of records ahead of the bin updates
+    bool scanned = false;
+    if( stagedKeys.size() - head < 2 * cfg.dmaChunkBytes / sizeof( uint64_t ) )
+      scanned = dma.clock();
+    for( unsigned u = 0; u < cfg.histUpdates && head < stagedKeys.size(); u++ ) {
+      if( !update( stagedKeys[head], op == HIST_OP::COUNT ? 1 : stagedValues[head] ) )
+        break;
+      head++;
+    }
+    if( head == stagedKeys.size() ) {
+      stagedKeys.clear();
+      stagedValues.clear();
+      head = 0;
+      if( scanned )
+        phase = PHASE::FLUSH;
+    }
+    return false;
+  }
+  case PHASE::FLUSH:
+    if( resident ) {
+      dma.start( dst, window, bins * sizeof( uint64_t ) );
+      phase = PHASE::DRAIN;
+      return false;
+    }
+    // One line evicted per cycle
+    while( flushSlot < tags.size() && tags[flushSlot] == NO_LINE )
+      flushSlot++;
+    if( flushSlot < tags.size() ) {
+      if( evict( flushSlot ) )
+        flushSlot++;
+      return false;
+    }
+    phase = PHASE::DRAIN;
+    return false;
+  case PHASE::DRAIN:
+    if( !dma.clock() )
+      return false;
+    for( auto& sp : spills )
+      if( sp.state != SPILL_STATE::FREE )
+        return false;
+    phase = PHASE::IDLE;
+    return true;
+  }
+  return false;
+}
+
+// Fold one record into its SRAM bin. False when it must wait for a spill.
+bool Histogram::update( uint64_t key, uint64_t value ) {
+  uint64_t bin = key >> shift;
+  if( bin >= bins )
+    return true;
+  uint64_t word = bin;
+  if( !resident ) {
+    uint64_t line = bin / lineBins;
+    uint64_t slot = line % tags.size();
+    if( tags[slot] != line ) {
+      if( tags[slot] != NO_LINE && !evict( slot ) )
+        return false;
+      tags[slot] = line;
+    }
+    word = slot * lineBins + bin % lineBins;
+  }
+  uint64_t              addr = window + word * sizeof( uint64_t );
+  uint64_t              agg;
+  MemEventBase::dataVec d( sizeof( agg ) );
+  parent->read( addr, d.size(), d );
+  std::memcpy( &agg, d.data(), sizeof( agg ) );
+  agg = combine( op, agg, value );
+  std::memcpy( d.data(), &agg, sizeof( agg ) );
+  parent->write( addr, d.size(), &d );
+  return true;
+}
+
+uint64_t Histogram::lineBytes( uint64_t line ) {
+  return std::min( lineBins, bins - line * lineBins ) * sizeof( uint64_t );
+}
+
+// Move the partials of a cached line out of SRAM and start adding them into dst
+bool Histogram::evict( uint64_t slot ) {
+  uint64_t line = tags[slot];
+  Spill*   sp   = nullptr;
+  for( auto& s : spills ) {
+    if( s.state != SPILL_STATE::FREE && s.line == line )
+      return false;
+    if( s.state == SPILL_STATE::FREE && !sp )
+      sp = &s;
+  }
+  if( !sp )
+    return false;
+
+  uint64_t addr = window + slot * lineBins * sizeof( uint64_t );
+  sp->partial.resize( lineBytes( line ) );
+  parent->read( addr, sp->partial.size(), sp->partial );
+  MemEventBase::dataVec z( lineBins * sizeof( uint64_t ), 0 );
+  parent->write( addr, z.size(), &z );
+  tags[slot] = NO_LINE;
+
+  sp->line  = line;
+  sp->state = SPILL_STATE::READING;
+  sp->data.resize( sp->partial.size() );
+  size_t idx = sp - spills.data();
+  parent->output->verbose( CALL_INFO, 4, 0, "Histogram: spill line=%" PRId64 " slot=%" PRId64 "\n", line, slot );
+  parent->m_issueDRAMRequest(
+    dst + line * lineBins * sizeof( uint64_t ), &sp->data, false,
+    [this, idx]( const MemEventBase::dataVec& d ) {
+      Spill& s = spills[idx];
+      assert( s.state == SPILL_STATE::READING && d.size() == s.data.size() );
+      s.data  = d;
+      s.state = SPILL_STATE::READY;
+    }
+  );
+  return true;
+}
+
+// Add landed dst lines to their partials and write them back
+void Histogram::issueSpills() {
+  for( size_t i = 0; i < spills.size(); i++ ) {
+    Spill& s = spills[i];
+    if( s.state != SPILL_STATE::READY )
+      continue;
+    for( size_t off = 0; off < s.data.size(); off += sizeof( uint64_t ) ) {
+      uint64_t a, b;
+      std::memcpy( &a, &s.data[off], sizeof( a ) );
+      std::memcpy( &b, &s.partial[off], sizeof( b ) );
+      a = combine( op, a, b );
+      std::memcpy( &s.data[off], &a, sizeof( a ) );
+    }
+    s.state = SPILL_STATE::WRITING;
+    parent->m_issueDRAMRequest(
+      dst + s.line * lineBins * sizeof( uint64_t ), &s.data, true,
+      [this, i]( const MemEventBase::dataVec& ) {
+        Spill& ws = spills[i];
+        assert( ws.state == SPILL_STATE::WRITING );
+        ws.state = SPILL_STATE::FREE;
+        ws.line  = NO_LINE;
+      }
+    );
+  }
+}
+
+SpMV::SpMV( TCLPIM* p ) : FSM( p ), dma( p ) {};
+
+// Param 0: y Address
+// Param 1: row_ptr Address ( rows + 1 entries )
+// Param 2: col_idx Address
+// Param 3: values Address
+// Param 4: x Address
+// Param 5: Number of Rows
+// Param 6: Scratch Address (SRAM)
+// Param 7: x Cache Bytes ( from the end of SRAM, 0 disables the cache )
+
+void SpMV::start( uint64_t params[NUM_FUNC_PARAMS] ) {
+  y                   = params[0];
+  rowPtr              = params[1];
+  colIdx              = params[2];
+  values              = params[3];
+  x                   = params[4];
+  rows                = params[5];
+  acc                 = params[6];
+  uint64_t cacheBytes = params[7];
+  uint64_t lineBytes  = parent->getConfig().gsBurstBytes;
+  auto     inf        = parent->getDecodeInfo( acc );
+  if( !inf.isIO || inf.pimAccType != PIM_ACCESS_TYPE::SRAM )
+    parent->output->fatal( CALL_INFO, -1, "SpMV: scratch address 0x%" PRIx64 " must be SRAM\n", acc );
+  cache = SRAM_BASE + SRAM_SIZE - cacheBytes / lineBytes * lineBytes;
+  if( cacheBytes > SRAM_SIZE || cache < acc + sizeof( double ) )
+    parent->output->fatal( CALL_INFO, -1, "SpMV: %" PRId64 " x cache bytes leave no room for row sums\n", cacheBytes );
+  accRows = ( cache - acc ) / sizeof( double );
+  tags.assign( cacheBytes / lineBytes, ~0ull );
+  assert( window.empty() && missing.empty() && readsInFlight == 0 );
+  parent->output->verbose(
+    CALL_INFO, 3, 0, "SpMV: rows=%" PRId64 " y=0x%" PRIx64 " x=0x%" PRIx64 " block_rows=%" PRId64 " cache_lines=%zu\n",
+    rows, y, x, accRows, tags.size()
+  );
+  r0    = 0;
+  phase = PHASE::IDLE;
+  if( rows )
+    startBlock();
+}
+
+// Fetch row_ptr for the next block of rows
+void SpMV::startBlock() {
+  nr = std::min( accRows, rows - r0 );
+  ptr.clear();
+  dma.start( DMAEngine::NO_DST, { rowPtr + r0 * sizeof( uint64_t ) }, ( nr + 1 ) * sizeof( uint64_t ),
+    [this]( DMAEngine::Buffers& b ) {
+      const uint64_t* p = kernels::elems<uint64_t>( b[0] );
+      ptr.insert( ptr.end(), p, p + b[0].size() / sizeof( uint64_t ) );
+    },
+    true );
+  phase = PHASE::ROWS;
+}
+
+// Clear the row sums and stream the block's col_idx and values together
+void SpMV::startNonzeros() {
+  MemEventBase::dataVec z( nr * sizeof( double ), 0 );
+  parent->write( acc, z.size(), &z );
+  stagedCols.clear();
+  stagedVals.clear();
+  head   = 0;
+  nextK  = ptr[0];
+  curRow = 0;
+  parent->output->verbose(
+    CALL_INFO, 4, 0, "SpMV: block row=%" PRId64 " rows=%" PRId64 " nnz=%" PRId64 "\n", r0, nr, ptr[nr] - ptr[0]
+  );
+  dma.start( DMAEngine::NO_DST, { colIdx + ptr[0] * sizeof( uint64_t ), values + ptr[0] * sizeof( double ) },
+    ( ptr[nr] - ptr[0] ) * sizeof( uint64_t ),
+    [this]( DMAEngine::Buffers& b ) {
+      size_t          n = b[0].size() / sizeof( uint64_t );
+      const uint64_t* c = kernels::elems<uint64_t>( b[0] );
+      const double*   v = kernels::elems<double>( b[1] );
+      stagedCols.insert( stagedCols.end(), c, c + n );
+      stagedVals.insert( stagedVals.end(), v, v + n );
+    },
+    true );
+  phase = PHASE::NNZ;
+}
+
+bool SpMV::clock() {
+  const TCLPIMConfig& cfg = parent->getConfig();
+  switch( phase ) {
+  case PHASE::IDLE: return true;
+  case PHASE::ROWS:
+    if( dma.clock() )
+      startNonzeros();
+    return false;
+  case PHASE::NNZ: {
+    fetch();
+    // Stage at most two chunks of nonzeros ahead of the window
+    bool streamed = false;
+    if( stagedCols.size() - head < 2 * cfg.dmaChunkBytes / sizeof( uint64_t ) )
+      streamed = dma.clock();
+    admit();
+    retire();
+    if( head == stagedCols.size() ) {
+      stagedCols.clear();
+      stagedVals.clear();
+      head = 0;
+      if( streamed && window.empty() ) {
+        dma.start( y + r0 * sizeof( double ), acc, nr * sizeof( double ) );
+        phase = PHASE::FLUSH;
+      }
+    }
+    return false;
+  }
+  case PHASE::FLUSH:
+    if( !dma.clock() )
+      return false;
+    r0 += nr;
+    if( r0 < rows ) {
+      startBlock();
+      return false;
+    }
+    phase = PHASE::IDLE;
+    return true;
+  }
+  return false;
+}
+
+// Move staged nonzeros into the window, looking their x up in the cache
+void SpMV::admit() {
+  const TCLPIMConfig& cfg       = parent->getConfig();
+  uint64_t            lineBytes = cfg.gsBurstBytes;
+  for( unsigned n = 0; n < cfg.spmvLanes && head < stagedCols.size() && window.size() < cfg.spmvWindow; n++ ) {
+    while( ptr[curRow + 1] <= nextK )
+      curRow++;
+    Entry    e;
+    uint64_t addr = x + stagedCols[head] * sizeof( double );
+    e.row         = curRow;
+    e.val         = stagedVals[head];
+    e.line        = addr & ~uint64_t( lineBytes - 1 );
+    e.off         = addr - e.line;
+    head++;
+    nextK++;
+
+    auto inf = parent->getDecodeInfo( addr );
+    if( inf.isIO && inf.pimAccType != PIM_ACCESS_TYPE::SRAM )
+      parent->output->fatal( CALL_INFO, -1, "SpMV: x address 0x%" PRIx64 " must be SRAM or DRAM\n", addr );
+    uint64_t slot = tags.empty() ? 0 : ( e.line / lineBytes ) % tags.size();
+    if( inf.isIO || ( !tags.empty() && tags[slot] == e.line ) ) {
+      MemEventBase::dataVec d( sizeof( double ) );
+      parent->read( inf.isIO ? addr : cache + slot * lineBytes + e.off, d.size(), d );
+      std::memcpy( &e.x, d.data(), sizeof( e.x ) );
+      e.ready = true;
+    } else if( missing.insert( e.line ).second ) {
+      toFetch.push_back( e.line );
+    }
+    window.push_back( e );
+  }
+}
+
+// One x line read per cycle
+void SpMV::fetch() {
+  if( toFetch.empty() || readsInFlight >= parent->getConfig().gsMaxOutstanding )
+    return;
+  uint64_t              line = toFetch.front();
+  MemEventBase::dataVec d( parent->getConfig().gsBurstBytes );
+  toFetch.pop_front();
+  readsInFlight++;
+  parent->m_issueDRAMRequest( line, &d, false, [this, line]( const MemEventBase::dataVec& r ) {
+    readsInFlight--;
+    filled( line, r );
+  } );
+}
+
+void SpMV::filled( uint64_t line, const MemEventBase::dataVec& d ) {
+  if( !tags.empty() ) {
+    uint64_t slot = ( line / d.size() ) % tags.size();
+    MemEventBase::dataVec fill( d );
+    tags[slot] = line;
+    parent->write( cache + slot * fill.size(), fill.size(), &fill );
+  }
+  for( auto& e : window )
+    if( !e.ready && e.line == line ) {
+      std::memcpy( &e.x, &d[e.off], sizeof( e.x ) );
+      e.ready = true;
+    }
+  missing.erase( line );
+}
+
+// Accumulate ready nonzeros into their SRAM row sums in CSR order
+void SpMV::retire() {
+  for( unsigned n = 0; n < parent->getConfig().spmvLanes && !window.empty() && window.front().ready; n++ ) {
+    const Entry&          e    = window.front();
+    uint64_t              addr = acc + e.row * sizeof( double );
+    double                sum;
+    MemEventBase::dataVec d( sizeof( sum ) );
+    parent->read( addr, d.size(), d );
+    std::memcpy( &sum, d.data(), sizeof( sum ) );
+    sum += e.val * e.x;
+    std::memcpy( d.data(), &sum, sizeof( sum ) );
+    parent->write( addr, d.size(), &d );
+    window.pop_front();
+  }
+}
+
+Gemv::Gemv( TCLPIM* p ) : FSM( p ), loads{ DMAEngine( p ), DMAEngine( p ) }, out( p ) {};
+
+// Param 0: Y Address
+// Param 1: W Address
+// Param 2: B Address (SRAM)
+// Param 3: Number of Rows
+// Param 4: Number of Columns
+// Param 5: gemvCtrl( EW_TYPE, n )
+// Param 6: W Row Pitch in bytes ( 0 packs rows )
+
+void Gemv::start( uint64_t params[NUM_FUNC_PARAMS] ) {
+  y             = params[0];
+  w             = params[1];
+  uint64_t bsrc = params[2];
+  rows          = params[3];
+  cols          = params[4];
+  uint64_t ctrl = params[5];
+  type          = static_cast<EW_TYPE>( ctrl & 0xff );
+  n             = ( ctrl >> 8 ) & 0xff;
+  if( ( type != EW_TYPE::I8 && type != EW_TYPE::F32 ) || n == 0 || ( ctrl & ~0xffffull ) != 0 )
+    parent->output->fatal( CALL_INFO, -1, "Gemv: bad control word 0x%" PRIx64 "\n", ctrl );
+  uint64_t eb       = kernels::elemBytes( type );
+  uint64_t rowBytes = cols * eb;
+  pitch             = params[6] ? params[6] : rowBytes;
+  if( pitch < rowBytes )
+    parent->output->fatal( CALL_INFO, -1, "Gemv: pitch %" PRId64 " is shorter than a row\n", pitch );
+  auto inf = parent->getDecodeInfo( bsrc );
+  if( !inf.isIO || inf.pimAccType != PIM_ACCESS_TYPE::SRAM )
+    parent->output->fatal( CALL_INFO, -1, "Gemv: B address 0x%" PRIx64 " must be SRAM\n", bsrc );
+  if( bsrc + cols * n * eb > SRAM_BASE + SRAM_SIZE )
+    parent->output->fatal( CALL_INFO, -1, "Gemv: %" PRId64 "x%" PRId64 " B does not fit in SRAM\n", cols, n );
+  inf = parent->getDecodeInfo( y );
+  if( inf.isIO && inf.pimAccType != PIM_ACCESS_TYPE::SRAM )
+    parent->output->fatal( CALL_INFO, -1, "Gemv: Y address must be SRAM or DRAM\n" );
+  b.resize( cols * n * eb );
+  parent->read( bsrc, b.size(), b );
+
+  // A buffer holds at least one row
+  batchRows = std::max<uint64_t>( 1, parent->getConfig().gemvBufferBytes / std::max<uint64_t>( rowBytes, 1 ) );
+  nextRow   = 0;
+  cur       = 0;
+  busy      = 0;
+  stalls    = 0;
+  assert( out.done() );
+  out.start( y );
+  parent->output->verbose(
+    CALL_INFO, 3, 0, "Gemv: type=%d rows=%" PRId64 " cols=%" PRId64 " n=%" PRId64 " batch_rows=%" PRId64 "\n",
+    static_cast<int>( type ), rows, cols, n, batchRows
+  );
+  startLoad( 0 );
+  startLoad( 1 );
+}
+
+// Stream the next batch of weight rows into buffer i
+void Gemv::startLoad( unsigned i ) {
+  Buffer& buf = bufs[i];
+  if( nextRow >= rows ) {
+    buf.state = BUF_STATE::EMPTY;
+    return;
+  }
+  buf.row0  = nextRow;
+  buf.rows  = std::min( batchRows, rows - nextRow );
+  buf.state = BUF_STATE::LOADING;
+  buf.data.clear();
+  nextRow += buf.rows;
+  uint64_t                        rowBytes = cols * kernels::elemBytes( type );
+  std::vector<DMAEngine::Segment> segs;
+  for( uint64_t r = 0; r < buf.rows; r++ ) {
+    if( pitch == rowBytes && r > 0 ) {
+      segs.back().bytes += rowBytes;
+      continue;
+    }
+    DMAEngine::Segment seg;
+    seg.srcs  = { w + ( buf.row0 + r ) * pitch };
+    seg.bytes = rowBytes;
+    segs.push_back( seg );
+  }
+  loads[i].start(
+    segs, [&buf]( DMAEngine::Buffers& d ) { buf.data.insert( buf.data.end(), d[0].begin(), d[0].end() ); }, true
+  );
+}
+
+bool Gemv::clock() {
+  for( unsigned i = 0; i < 2; i++ )
+    if( bufs[i].state == BUF_STATE::LOADING && loads[i].clock() )
+      bufs[i].state = BUF_STATE::FULL;
+
+  Buffer& buf = bufs[cur];
+  out.flush( buf.state == BUF_STATE::EMPTY && !busy );
+  if( busy ) {
+    if( --busy == 0 ) {
+      out.data().insert( out.data().end(), result.begin(), result.end() );
+      startLoad( cur );
+      cur ^= 1;
+    }
+    return false;
+  }
+  if( buf.state == BUF_STATE::FULL ) {
+    // Hold compute while earlier results are still draining
+    if( out.size() < 2 * parent->getConfig().dmaChunkBytes )
+      compute( buf );
+    return false;
+  }
+  if( buf.state == BUF_STATE::LOADING ) {
+    stalls++;
+    return false;
+  }
+  if( !out.done() )
+    return false;
+  parent->output->verbose( CALL_INFO, 2, 0, "Gemv: done, compute waited %" PRId64 " cycles on loads\n", stalls );
+  return true;
+}
+
+// Multiply the buffered rows by B and model the MAC array latency
+void Gemv::compute( Buffer& buf ) {
+  result.resize( buf.rows * n * sizeof( int32_t ) );
+  uint64_t eb = kernels::elemBytes( type );
+  for( uint64_t r = 0; r < buf.rows; r++ ) {
+    if( type == EW_TYPE::I8 )
+      kernels::gemvRow<int8_t, int32_t>(
+        kernels::elems<int8_t>( buf.data ) + r * cols, kernels::elems<int8_t>( b ), cols, n,
+        kernels::elems<int32_t>( result ) + r * n
+      );
+    else
+      kernels::gemvRow<float, float>(
+        kernels::elems<float>( buf.data ) + r * cols, kernels::elems<float>( b ), cols, n,
+        kernels::elems<float>( result ) + r * n
+      );
+  }
+  uint64_t macs = buf.rows * cols * n;
+  uint64_t lane = parent->getConfig().gemvMacs;
+  busy          = std::max<uint64_t>( 1, ( macs + lane - 1 ) / lane );
+  parent->output->verbose(
+    CALL_INFO, 4, 0, "Gemv: rows %" PRId64 "-%" PRId64 " cycles=%" PRId64 " bytes=%" PRId64 "\n", buf.row0,
+    buf.row0 + buf.rows - 1, busy, buf.rows * cols * eb
+  );
+}
+
+Codec::Codec( TCLPIM* p, bool decompress ) : FSM( p ), decompress( decompress ), dma( p ), out( p ) {};
+
+// Param 0: Destination Address
+// Param 1: Source Address
+// Param 2: Number of Words ( compress ) or Compressed Bytes ( decompress )
+// Param 3: Result Address (SRAM). Receives the number of bytes written.
+
+void Codec::start( uint64_t params[NUM_FUNC_PARAMS] ) {
+  uint64_t dst      = params[0];
+  uint64_t numBytes = decompress ? params[2] : params[2] * sizeof( uint64_t );
+  result            = params[3];
+  auto inf          = parent->getDecodeInfo( result );
+  if( !inf.isIO || inf.pimAccType != PIM_ACCESS_TYPE::SRAM )
+    parent->output->fatal( CALL_INFO, -1, "Codec: result address 0x%" PRIx64 " must be SRAM\n", result );
+  inf = parent->getDecodeInfo( dst );
+  if( inf.isIO && inf.pimAccType != PIM_ACCESS_TYPE::SRAM )
+    parent->output->fatal( CALL_INFO, -1, "Codec: destination must be SRAM or DRAM\n" );
+  if( decompress && ( numBytes % 8 ) != 0 )
+    parent->output->fatal( CALL_INFO, -1, "Codec: compressed size %" PRId64 " is not a multiple of 8\n", numBytes );
+
+  busy = 0;
+  in.clear();
+  assert( out.done() );
+  out.start( dst );
+  parent->output->verbose(
+    CALL_INFO, 3, 0, "%s: dst=0x%" PRIx64 " src=0x%" PRIx64 " bytes=%" PRId64 "\n",
+    decompress ? "Decompress" : "Compress", dst, params[1], numBytes
+  );
+  dma.start(
+    DMAEngine::NO_DST, { params[1] }, numBytes,
+    [this]( DMAEngine::Buffers& b ) { in.insert( in.end(), b[0].begin(), b[0].end() ); }, true
+  );
+  scanned = !dma.busy();
+}
+
+bool Codec::clock() {
+  uint64_t chunk = parent->getConfig().dmaChunkBytes;
+  // Loads run ahead of the codec by at most two chunks
+  if( !scanned && in.size() < 2 * chunk )
+    scanned = dma.clock();
+  if( busy )
+    busy--;
+  if( !busy && out.size() < 2 * chunk )
+    code();
+  out.flush( scanned && in.empty() && !busy );
+  if( !scanned || busy || !in.empty() || !out.done() )
+    return false;
+  uint64_t              written = out.written();
+  MemEventBase::dataVec d( sizeof( written ) );
+  std::memcpy( d.data(), &written, sizeof( written ) );
+  parent->write( result, d.size(), &d );
+  parent->output->verbose(
+    CALL_INFO, 2, 0, "%s: %" PRId64 " bytes written\n", decompress ? "Decompress" : "Compress", written
+  );
+  return true;
+}
+
+// Code the next block once its input has staged, and start its modeled latency
+void Codec::code() {
+  const TCLPIMConfig& cfg = parent->getConfig();
+  uint64_t            words;
+  if( decompress ) {
+    if( in.size() < 2 * sizeof( uint64_t ) ) {
+      if( scanned && !in.empty() )
+        parent->output->fatal( CALL_INFO, -1, "Decompress: compressed stream is truncated\n" );
+      return;
+    }
+    uint64_t header;
+    std::memcpy( &header, in.data(), sizeof( header ) );
+    if( !kernels::codecHeaderValid( header ) )
+      parent->output->fatal( CALL_INFO, -1, "Decompress: bad block header 0x%" PRIx64 "\n", header );
+    uint64_t bytes = kernels::codecBlockBytes( header );
+    if( in.size() < bytes ) {
+      if( scanned )
+        parent->output->fatal( CALL_INFO, -1, "Decompress: compressed stream is truncated\n" );
+      return;
+    }
+    words = ( header >> 8 ) & 0xff;
+    kernels::decodeBlock( in.data(), out.data() );
+    in.erase( in.begin(), in.begin() + bytes );
+    busy = cfg.codecBlockCycles + ( words + cfg.codecDecodeWords - 1 ) / cfg.codecDecodeWords;
+  } else {
+    // The last block may be short
+    words = std::min<uint64_t>( in.size() / sizeof( uint64_t ), CODEC_BLOCK_WORDS );
+    if( words == 0 || ( words < CODEC_BLOCK_WORDS && !scanned ) )
+      return;
+    kernels::encodeBlock( kernels::elems<uint64_t>( in ), words, out.data() );
+    in.erase( in.begin(), in.begin() + words * sizeof( uint64_t ) );
+    busy = cfg.codecBlockCycles + ( words + cfg.codecEncodeWords - 1 ) / cfg.codecEncodeWords;
+  }
+}
+
+SLS::SLS( TCLPIM* p ) : FSM( p ), idxDma( p ), lenDma( p ), pooled( p ) {};
+
+// Param 0: Output Address ( bags x dim fp32 )
+// Param 1: Table Address (DRAM)
+// Param 2: Indices Address
+// Param 3: Lengths Address
+// Param 4: Number of Bags
+// Param 5: slsCtrl( EW_TYPE, dim )
+// Param 6: Accumulator Address (SRAM)
+// Param 7: Table Row Pitch in bytes ( 0 packs rows )
+
+void SLS::start( uint64_t params[NUM_FUNC_PARAMS] ) {
+  uint64_t out  = params[0];
+  table         = params[1];
+  bags          = params[4];
+  uint64_t ctrl = params[5];
+  acc           = params[6];
+  type          = static_cast<EW_TYPE>( ctrl & 0xff );
+  dim           = ( ctrl >> 8 ) & 0xffffff;
+  if( ( type != EW_TYPE::F32 && type != EW_TYPE::I8 ) || dim == 0 || ( ctrl >> 32 ) != 0 )
+    parent->output->fatal( CALL_INFO, -1, "SLS: bad control word 0x%" PRIx64 "\n", ctrl );
+  rowBytes = type == EW_TYPE::F32 ? dim * sizeof( float ) : dim + 2 * sizeof( float );
+  pitch    = params[7] ? params[7] : rowBytes;
+  if( pitch < rowBytes )
+    parent->output->fatal( CALL_INFO, -1, "SLS: pitch %" PRId64 " is shorter than a row\n", pitch );
+  if( parent->getDecodeInfo( table ).isIO )
+    parent->output->fatal( CALL_INFO, -1, "SLS: table address 0x%" PRIx64 " must be DRAM\n", table );
+  auto inf = parent->getDecodeInfo( acc );
+  if( !inf.isIO || inf.pimAccType != PIM_ACCESS_TYPE::SRAM || acc + dim * sizeof( float ) > SRAM_BASE + SRAM_SIZE )
+    parent->output->fatal( CALL_INFO, -1, "SLS: %" PRId64 " wide accumulator must fit in SRAM\n", dim );
+  inf = parent->getDecodeInfo( out );
+  if( inf.isIO && inf.pimAccType != PIM_ACCESS_TYPE::SRAM )
+    parent->output->fatal( CALL_INFO, -1, "SLS: output must be SRAM or DRAM\n" );
+
+  nextBag    = 0;
+  remaining  = 0;
+  busy       = 0;
+  retiredBag = ~0ull;
+  bagDone    = false;
+  stagedIdx.clear();
+  stagedLen.clear();
+  assert( window.empty() && outstanding == 0 && pooled.done() );
+  pooled.start( out );
+  parent->output->verbose(
+    CALL_INFO, 3, 0, "SLS: type=%d dim=%" PRId64 " bags=%" PRId64 " out=0x%" PRIx64 " table=0x%" PRIx64 "\n",
+    static_cast<int>( type ), dim, bags, out, table
+  );
+  // The index count is the sum of the lengths, so indices are requested as
+  // lengths arrive
+  idxAddr   = params[2];
+  idxWanted = 0;
+  lenDma.start( DMAEngine::NO_DST, { params[3] }, bags * sizeof( uint64_t ), [this]( DMAEngine::Buffers& b ) {
+    const uint64_t* p = kernels::elems<uint64_t>( b[0] );
+    for( size_t i = 0; i < b[0].size() / sizeof( uint64_t ); i++ ) {
+      stagedLen.push_back( p[i] );
+      idxWanted += p[i];
+    }
+  }, true );
+}
+
+bool SLS::clock() {
+  const TCLPIMConfig& cfg   = parent->getConfig();
+  uint64_t            ahead = 2 * cfg.dmaChunkBytes / sizeof( uint64_t );
+  if( lenDma.busy() && stagedLen.size() < ahead )
+    lenDma.clock();
+  if( idxDma.busy() ) {
+    if( stagedIdx.size() < ahead )
+      idxDma.clock();
+  } else if( idxWanted && stagedIdx.size() < ahead ) {
+    uint64_t n = std::min( idxWanted, 2 * ahead );
+    idxDma.start( DMAEngine::NO_DST, { idxAddr }, n * sizeof( uint64_t ), [this]( DMAEngine::Buffers& b ) {
+      const uint64_t* p = kernels::elems<uint64_t>( b[0] );
+      stagedIdx.insert( stagedIdx.end(), p, p + b[0].size() / sizeof( uint64_t ) );
+    }, true );
+    idxAddr += n * sizeof( uint64_t );
+    idxWanted -= n;
+  }
+
+  if( busy )
+    busy--;
+  // The accumulator is reused once the finished bag has been copied out
+  if( !busy && bagDone && pooled.size() < 2 * cfg.dmaChunkBytes )
+    writeBag();
+  if( !busy && !bagDone )
+    retire();
+  admit();
+  bool pooledAll = nextBag == bags && remaining == 0 && window.empty() && !busy && !bagDone;
+  // Bags finish in order, so pooled vectors leave as contiguous chunks
+  pooled.flush( pooledAll );
+  return pooledAll && pooled.done();
+}
+
+// Start the next table row, or continue requesting pieces of a long one.
+// One DRAM read issues per cycle.
+void SLS::admit() {
+  const TCLPIMConfig& cfg = parent->getConfig();
+  if( !window.empty() && !window.back().empty && window.back().issued < rowBytes ) {
+    issue( window.back() );
+    return;
+  }
+  if( window.size() >= cfg.gsMaxOutstanding || outstanding >= cfg.gsMaxOutstanding )
+    return;
+  if( remaining == 0 ) {
+    if( nextBag == bags || stagedLen.empty() )
+      return;
+    remaining = stagedLen.front();
+    stagedLen.pop_front();
+    if( remaining == 0 ) {
+      Entry e;
+      e.bag   = nextBag++;
+      e.last  = true;
+      e.empty = true;
+      window.push_back( e );
+      return;
+    }
+    nextBag++;
+  }
+  if( stagedIdx.empty() )
+    return;
+  Entry e;
+  e.bag  = nextBag - 1;
+  e.last = --remaining == 0;
+  e.addr = table + stagedIdx.front() * pitch;
+  e.data.resize( rowBytes );
+  stagedIdx.pop_front();
+  window.push_back( e );
+  issue( window.back() );
+}
+
+// Request the next piece of a row
+void SLS::issue( Entry& e ) {
+  uint64_t              off = e.issued;
+  MemEventBase::dataVec d( std::min<uint64_t>( rowBytes - off, parent->getConfig().dmaChunkBytes ) );
+  if( parent->getDecodeInfo( e.addr + off ).isIO )
+    parent->output->fatal( CALL_INFO, -1, "SLS: table row 0x%" PRIx64 " leaves DRAM\n", e.addr );
+  e.issued += d.size();
+  e.pending++;
+  outstanding++;
+  Entry* ep = &e;
+  parent->m_issueDRAMRequest( e.addr + off, &d, false, [this, ep, off]( const MemEventBase::dataVec& r ) {
+    std::copy( r.begin(), r.end(), ep->data.begin() + off );
+    ep->pending--;
+    outstanding--;
+  } );
+}
+
+// Pool the oldest row once it has landed and model the adder latency
+void SLS::retire() {
+  if( window.empty() )
+    return;
+  Entry& e = window.front();
+  if( e.issued < rowBytes && !e.empty )
+    return;
+  if( e.pending )
+    return;
+  uint64_t              accBytes = dim * sizeof( float );
+  MemEventBase::dataVec a( accBytes, 0 );
+  // The first row of a bag starts from zero
+  bool first = e.empty || retiredBag != e.bag;
+  if( !first )
+    parent->read( acc, accBytes, a );
+  if( !e.empty ) {
+    float* sum = kernels::elems<float>( a );
+    if( type == EW_TYPE::F32 ) {
+      kernels::poolRow<float>( kernels::elems<float>( e.data ), 1, 0, dim, sum );
+    } else {
+      float sb[2];
+      std::memcpy( sb, &e.data[dim], sizeof( sb ) );
+      kernels::poolRow<int8_t>( reinterpret_cast<const int8_t*>( e.data.data() ), sb[0], sb[1], dim, sum );
+    }
+  }
+  parent->write( acc, accBytes, &a );
+  retiredBag = e.bag;
+  busy       = e.empty ? 1 : ( dim + parent->getConfig().slsLanes - 1 ) / parent->getConfig().slsLanes;
+  bagDone    = e.last;
+  window.pop_front();
+}
+
+// Append the finished bag to the pooled output once its last row has been added
+void SLS::writeBag() {
+  MemEventBase::dataVec a( dim * sizeof( float ) );
+  parent->read( acc, a.size(), a );
+  pooled.data().insert( pooled.data().end(), a.begin(), a.end() );
+  bagDone = false;
+}
+
+Frontier::Frontier( TCLPIM* p ) : FSM( p ), dma( p ), words( p ), out( p ) {};
+
+// Param 0: Next Frontier Address
+// Param 1: Frontier Address
+// Param 2: Frontier Size
+// Param 3: Row Pointer Address (DRAM)
+// Param 4: Column Index Address (DRAM)
+// Param 5: State Address (DRAM)
+// Param 6: Result Address (SRAM)
+// Param 7: bfsCtrl( BFS_MODE, level )
+
+void Frontier::start( uint64_t params[NUM_FUNC_PARAMS] ) {
+  uint64_t next = params[0];
+  uint64_t n    = params[2];
+  rowPtr        = params[3];
+  colIdx        = params[4];
+  state         = params[5];
+  result        = params[6];
+  uint64_t ctrl = params[7];
+  mode          = static_cast<BFS_MODE>( ctrl & 0xff );
+  level         = ctrl >> 8;
+  if( mode > BFS_MODE::RELAX )
+    parent->output->fatal( CALL_INFO, -1, "Frontier: bad control word 0x%" PRIx64 "\n", ctrl );
+  auto inf = parent->getDecodeInfo( result );
+  if( !inf.isIO || inf.pimAccType != PIM_ACCESS_TYPE::SRAM )
+    parent->output->fatal( CALL_INFO, -1, "Frontier: result address 0x%" PRIx64 " must be SRAM\n", result );
+  for( uint64_t a : { rowPtr, colIdx, state } )
+    if( parent->getDecodeInfo( a ).isIO )
+      parent->output->fatal( CALL_INFO, -1, "Frontier: graph and state must be in DRAM\n" );
+  inf = parent->getDecodeInfo( next );
+  if( inf.isIO && inf.pimAccType != PIM_ACCESS_TYPE::SRAM )
+    parent->output->fatal( CALL_INFO, -1, "Frontier: next frontier must be SRAM or DRAM\n" );
+
+  edgeBytes = ( mode == BFS_MODE::RELAX ? 2 : 1 ) * sizeof( uint64_t );
+  found     = 0;
+  edges     = 0;
+  scanned   = false;
+  stagedFrontier.clear();
+  emitted.clear();
+  assert( vertices.empty() && updates.empty() && words.empty() && waiting.empty() && out.done() );
+  assert( readsInFlight == 0 );
+  out.start( next );
+  parent->output->verbose(
+    CALL_INFO, 3, 0, "Frontier: mode=%d level=%" PRId64 " frontier=0x%" PRIx64 " size=%" PRId64 " next=0x%" PRIx64 "\n",
+    static_cast<int>( mode ), level, params[1], n, next
+  );
+  dma.start( DMAEngine::NO_DST, { params[1] }, n * sizeof( uint64_t ), [this]( DMAEngine::Buffers& b ) {
+    const uint64_t* p = kernels::elems<uint64_t>( b[0] );
+    stagedFrontier.insert( stagedFrontier.end(), p, p + b[0].size() / sizeof( uint64_t ) );
+  }, true );
+}
+
+bool Frontier::clock() {
+  const TCLPIMConfig& cfg = parent->getConfig();
+  if( !scanned && stagedFrontier.size() < 2 * cfg.dmaChunkBytes / sizeof( uint64_t ) )
+    scanned = dma.clock();
+  // The read slot goes to the stage nearest the state so the pipeline drains
+  bool issued = update();
+  if( !issued )
+    issued = readEdges();
+  if( !issued )
+    readVertex();
+  words.writeBack( out.writes() );
+  while( !vertices.empty() && vertices.front().pending == 0 && !vertices.front().needDist &&
+         vertices.front().begin == vertices.front().end )
+    vertices.pop_front();
+  bool expanded = scanned && stagedFrontier.empty() && vertices.empty() && updates.empty() && words.empty() &&
+                  readsInFlight == 0;
+  // State words and the next frontier share the write cap
+  out.flush( expanded, words.writes() );
+  if( !expanded || !out.done() )
+    return false;
+  uint64_t              r[2] = { found, edges };
+  MemEventBase::dataVec d( sizeof( r ) );
+  std::memcpy( d.data(), r, sizeof( r ) );
+  parent->write( result, d.size(), &d );
+  return true;
+}
+
+void Frontier::read( uint64_t addr, uint64_t bytes, std::function<void( const MemEventBase::dataVec& )> done ) {
+  MemEventBase::dataVec d( bytes );
+  readsInFlight++;
+  parent->m_issueDRAMRequest( addr, &d, false, [this, done]( const MemEventBase::dataVec& r ) {
+    readsInFlight--;
+    done( r );
+  } );
+}
+
+// Start the next frontier vertex with its row_ptr pair. A RELAX vertex
+// reads its distance the next time round.
+bool Frontier::readVertex() {
+  const TCLPIMConfig& cfg = parent->getConfig();
+  if( readsInFlight >= cfg.gsMaxOutstanding )
+    return false;
+  if( !vertices.empty() && vertices.back().needDist ) {
+    Vertex&  vx   = vertices.back();
+    uint64_t addr = state + vx.u * sizeof( uint64_t );
+    vx.needDist   = false;
+    HeldLines::Line* w = words.find( addr );
+    if( w && w->valid ) {
+      std::memcpy( &vx.dist, w->data.data(), sizeof( vx.dist ) );
+      return false;
+    }
+    Vertex* vp = &vx;
+    vx.pending++;
+    read( addr, sizeof( uint64_t ), [vp]( const MemEventBase::dataVec& d ) {
+      std::memcpy( &vp->dist, d.data(), sizeof( vp->dist ) );
+      vp->pending--;
     } );
-    dma_state = DMA_STATE::WAITING;
-    src += bytes;
-  } else if( dma_state == DMA_STATE::WRITE ) {
-    assert( word_counter >= words );
-    word_counter = word_counter - words;
-    if( word_counter > 0 ) {
-      parent->m_issueDRAMRequest( dst, &parent->buffer, WRITE, [this]( const MemEventBase::dataVec& d ) {
-        dma_state = DMA_STATE::READ;
-      } );
+    return true;
+  }
+  if( stagedFrontier.empty() || vertices.size() >= cfg.gsMaxOutstanding )
+    return false;
+  Vertex vx;
+  vx.u        = stagedFrontier.front();
+  vx.needDist = mode == BFS_MODE::RELAX;
+  vx.pending  = 1;
+  stagedFrontier.pop_front();
+  vertices.push_back( vx );
+  Vertex* vp = &vertices.back();
+  read( rowPtr + vx.u * sizeof( uint64_t ), 2 * sizeof( uint64_t ), [vp]( const MemEventBase::dataVec& d ) {
+    std::memcpy( &vp->begin, &d[0], sizeof( vp->begin ) );
+    std::memcpy( &vp->end, &d[8], sizeof( vp->end ) );
+    vp->pending--;
+  } );
+  return true;
+}
+
+// Request the next piece of the oldest edge list that is ready, while the
+// update queue has room
+bool Frontier::readEdges() {
+  const TCLPIMConfig& cfg = parent->getConfig();
+  if( updates.size() >= 2 * cfg.dmaChunkBytes / sizeof( uint64_t ) || readsInFlight >= cfg.gsMaxOutstanding )
+    return false;
+  for( auto& vx : vertices ) {
+    if( vx.pending || vx.needDist || vx.begin >= vx.end )
+      continue;
+    uint64_t n    = std::min<uint64_t>( vx.end - vx.begin, std::max<uint64_t>( 1, cfg.dmaChunkBytes / edgeBytes ) );
+    uint64_t dist = vx.dist;
+    read( colIdx + vx.begin * edgeBytes, n * edgeBytes, [this, dist]( const MemEventBase::dataVec& d ) {
+      expand( d, dist );
+    } );
+    vx.begin += n;
+    edges += n;
+    return true;
+  }
+  return false;
+}
+
+// Queue the neighbor updates of a landed piece of an edge list
+void Frontier::expand( const MemEventBase::dataVec& d, uint64_t dist ) {
+  const uint64_t* e = kernels::elems<const uint64_t>( d );
+  for( size_t i = 0; i < d.size() / edgeBytes; i++ ) {
+    Update up;
+    up.v    = e[i * edgeBytes / sizeof( uint64_t )];
+    up.word = state + up.v * sizeof( uint64_t );
+    if( mode == BFS_MODE::VISIT ) {
+      up.word = state + ( up.v / 64 ) * sizeof( uint64_t );
+      up.val  = 1ull << ( up.v % 64 );
+    } else if( mode == BFS_MODE::LEVEL ) {
+      up.val = level;
     } else {
-      parent->m_issueDRAMRequest( dst, &parent->buffer, WRITE, [this]( const MemEventBase::dataVec& d ) {
-        dma_state = DMA_STATE::DONE;
+      // Saturate so an unreached source never wraps to a short distance
+      uint64_t w = e[i * 2 + 1];
+      up.val     = dist > BFS_UNVISITED - w ? BFS_UNVISITED : dist + w;
+    }
+    updates.push_back( up );
+  }
+}
+
+// Apply the oldest neighbor update. True when it took the read slot.
+bool Frontier::update() {
+  if( updates.empty() )
+    return false;
+  Update           up = updates.front();
+  HeldLines::Line* w  = words.find( up.word );
+  if( w ) {
+    // Combine with the word already held, or wait for its read
+    if( w->valid )
+      apply( up.word, *w, up );
+    else
+      waiting[up.word].push_back( up );
+    updates.pop_front();
+    return false;
+  }
+  if( readsInFlight >= parent->getConfig().gsMaxOutstanding )
+    return false;
+  updates.pop_front();
+  uint64_t addr = up.word;
+  words.hold( addr, sizeof( uint64_t ) );
+  waiting[addr].push_back( up );
+  read( addr, sizeof( uint64_t ), [this, addr]( const MemEventBase::dataVec& d ) {
+    HeldLines::Line& w = *words.find( addr );
+    w.data             = d;
+    w.valid            = true;
+    for( const auto& wu : waiting.at( addr ) )
+      apply( addr, w, wu );
+    waiting.erase( addr );
+    words.release( addr );
+  } );
+  return true;
+}
+
+// Compare-and-set the state word and emit the neighbor when it changed
+void Frontier::apply( uint64_t addr, HeldLines::Line& w, const Update& up ) {
+  ATOMIC_OP op = mode == BFS_MODE::VISIT ? ATOMIC_OP::OR : mode == BFS_MODE::LEVEL ? ATOMIC_OP::CAS : ATOMIC_OP::UMIN;
+  uint64_t  old;
+  std::memcpy( &old, w.data.data(), sizeof( old ) );
+  uint64_t v = kernels::atomicApply<int64_t>( op, old, up.val, BFS_UNVISITED );
+  if( v == old )
+    return;
+  std::memcpy( w.data.data(), &v, sizeof( v ) );
+  words.changed( addr, w );
+  if( mode == BFS_MODE::RELAX && !emitted.insert( up.v ).second )
+    return;
+  out.push( up.v );
+  found++;
+}
+
+Bitmap::Bitmap( TCLPIM* p ) : FSM( p ), dma( p ) {};
+
+// Param 0: Destination Address ( 0 for none )
+// Param 1: Result Address (SRAM)
+// Param 2: bitmapCtrl( BITMAP_OP, sources )
+// Param 3: Number of Bytes ( must by divisible by 8 )
+// Param 4-7: Source Addresses
+
+void Bitmap::start( uint64_t params[NUM_FUNC_PARAMS] ) {
+  uint64_t  dst      = params[0];
+  result             = params[1];
+  uint64_t  ctrl     = params[2];
+  uint64_t  numBytes = params[3];
+  BITMAP_OP op       = static_cast<BITMAP_OP>( ctrl & 0xff );
+  unsigned  n        = ( ctrl >> 8 ) & 0xff;
+  if( op > BITMAP_OP::ANDNOT || n < 2 || n > DMAEngine::MAX_SOURCES || ( ctrl >> 16 ) != 0 )
+    parent->output->fatal( CALL_INFO, -1, "Bitmap: bad control word 0x%" PRIx64 "\n", ctrl );
+  if( ( numBytes % 8 ) != 0 )
+    parent->output->fatal( CALL_INFO, -1, "Bitmap: size %" PRId64 " is not a multiple of 8\n", numBytes );
+  auto inf = parent->getDecodeInfo( result );
+  if( !inf.isIO || inf.pimAccType != PIM_ACCESS_TYPE::SRAM )
+    parent->output->fatal( CALL_INFO, -1, "Bitmap: result address 0x%" PRIx64 " must be SRAM\n", result );
+
+  count = 0;
+  std::vector<uint64_t> srcs( params + 4, params + 4 + n );
+  parent->output->verbose(
+    CALL_INFO, 3, 0, "Bitmap: op=%d sources=%u dst=0x%" PRIx64 " srcA=0x%" PRIx64 " bytes=%" PRId64 "\n",
+    static_cast<int>( op ), n, dst, params[4], numBytes
+  );
+  // The popcount is a plain sum, so chunks may fold in any order
+  dma.start( dst ? dst : DMAEngine::NO_DST, srcs, numBytes, [this, op, n]( DMAEngine::Buffers& b ) {
+    count += kernels::bitmapOp( op, b, n );
+  } );
+}
+
+bool Bitmap::clock() {
+  if( !dma.clock() )
+    return false;
+  MemEventBase::dataVec d( sizeof( count ) );
+  std::memcpy( d.data(), &count, sizeof( count ) );
+  parent->write( result, d.size(), &d );
+  return true;
+}
+
+Checksum::Checksum( TCLPIM* p ) : FSM( p ), dma( p ), sumDma( p ), out( p ) {};
+
+// Param 0: Result Address (SRAM)
+// Param 1: Source Address
+// Param 2: Number of Bytes
+// Param 3: csumCtrl( CSUM_ALG, verify )
+// Param 4: Seed
+// Param 5: Block Bytes (verify)
+// Param 6: Stored Checksums Address (verify)
+// Param 7: Mismatch Index Address (verify, 0 for none)
+
+void Checksum::start( uint64_t params[NUM_FUNC_PARAMS] ) {
+  result            = params[0];
+  uint64_t numBytes = params[2];
+  uint64_t ctrl     = params[3];
+  seed              = params[4];
+  blockBytes        = params[5];
+  uint64_t dst      = params[7];
+  alg               = static_cast<CSUM_ALG>( ctrl & 0xff );
+  verify            = ( ctrl & CSUM_VERIFY ) != 0;
+  if( alg > CSUM_ALG::XXH64 || ( ctrl & ~( CSUM_VERIFY | 0xff ) ) != 0 )
+    parent->output->fatal( CALL_INFO, -1, "Checksum: bad control word 0x%" PRIx64 "\n", ctrl );
+  auto inf = parent->getDecodeInfo( result );
+  if( !inf.isIO || inf.pimAccType != PIM_ACCESS_TYPE::SRAM )
+    parent->output->fatal( CALL_INFO, -1, "Checksum: result address 0x%" PRIx64 " must be SRAM\n", result );
+  if( verify && blockBytes == 0 )
+    parent->output->fatal( CALL_INFO, -1, "Checksum: verify needs a block size\n" );
+  inf = parent->getDecodeInfo( dst );
+  if( verify && dst && inf.isIO && inf.pimAccType != PIM_ACCESS_TYPE::SRAM )
+    parent->output->fatal( CALL_INFO, -1, "Checksum: mismatch indices must go to SRAM or DRAM\n" );
+
+  hasher.reset( alg, seed );
+  scanned    = false;
+  blockFill  = 0;
+  blocks     = verify ? ( numBytes + blockBytes - 1 ) / blockBytes : 0;
+  block      = 0;
+  mismatches = 0;
+  digests.clear();
+  stagedSums.clear();
+  indices    = dst != 0;
+  assert( out.done() );
+  out.start( dst );
+  parent->output->verbose(
+    CALL_INFO, 3, 0, "Checksum: alg=%d verify=%d src=0x%" PRIx64 " bytes=%" PRId64 " block_bytes=%" PRId64 "\n",
+    static_cast<int>( alg ), verify, params[1], numBytes, blockBytes
+  );
+  // Digests are carried across chunks, so chunks are hashed in order
+  dma.start( DMAEngine::NO_DST, { params[1] }, numBytes, [this]( DMAEngine::Buffers& b ) {
+    if( verify )
+      hashBlocks( b[0] );
+    else
+      hasher.update( b[0].data(), b[0].size() );
+  }, true );
+  if( verify )
+    sumDma.start( DMAEngine::NO_DST, { params[6] }, blocks * sizeof( uint64_t ), [this]( DMAEngine::Buffers& b ) {
+      const uint64_t* p = kernels::elems<uint64_t>( b[0] );
+      stagedSums.insert( stagedSums.end(), p, p + b[0].size() / sizeof( uint64_t ) );
+    }, true );
+}
+
+bool Checksum::clock() {
+  if( !verify ) {
+    if( !dma.clock() )
+      return false;
+    uint64_t              digest = hasher.digest();
+    MemEventBase::dataVec d( sizeof( digest ) );
+    std::memcpy( d.data(), &digest, sizeof( digest ) );
+    parent->write( result, d.size(), &d );
+    return true;
+  }
+
+  // Stage at most two chunks of digests and stored checksums ahead of the compare
+  const TCLPIMConfig& cfg   = parent->getConfig();
+  uint64_t            ahead = 2 * cfg.dmaChunkBytes / sizeof( uint64_t );
+  if( !scanned && digests.size() < ahead ) {
+    scanned = dma.clock();
+    if( scanned && blockFill ) {
+      digests.push_back( hasher.digest() );
+      blockFill = 0;
+    }
+  }
+  if( sumDma.busy() && stagedSums.size() < ahead )
+    sumDma.clock();
+  for( ; !digests.empty() && !stagedSums.empty(); block++ ) {
+    if( digests.front() != stagedSums.front() ) {
+      mismatches++;
+      if( indices )
+        out.push( block );
+    }
+    digests.pop_front();
+    stagedSums.pop_front();
+  }
+  bool checked = scanned && block == blocks;
+  out.flush( checked );
+  if( !checked || !out.done() )
+    return false;
+  MemEventBase::dataVec d( sizeof( mismatches ) );
+  std::memcpy( d.data(), &mismatches, sizeof( mismatches ) );
+  parent->write( result, d.size(), &d );
+  return true;
+}
+
+// Hash a chunk block by block. Blocks may straddle chunks.
+void Checksum::hashBlocks( const MemEventBase::dataVec& d ) {
+  for( size_t off = 0; off < d.size(); ) {
+    size_t n = std::min<uint64_t>( d.size() - off, blockBytes - blockFill );
+    hasher.update( d.data() + off, n );
+    off += n;
+    blockFill += n;
+    if( blockFill == blockBytes ) {
+      digests.push_back( hasher.digest() );
+      hasher.reset( alg, seed );
+      blockFill = 0;
+    }
+  }
+}
+
+Stencil::Stencil( TCLPIM* p ) : FSM( p ) {};
+
+// Param 0: Destination Address (DRAM)
+// Param 1: Source Address (DRAM)
+// Param 2: Number of Rows
+// Param 3: Number of Columns
+// Param 4: stencilCtrl( STENCIL, EW_TYPE )
+// Param 5: Coefficients Address (SRAM, below the ring)
+// Param 6: Ring Address (SRAM, runs to the end of SRAM)
+// Param 7: Row Pitch in bytes ( 0 packs rows )
+
+void Stencil::start( uint64_t params[NUM_FUNC_PARAMS] ) {
+  dst           = params[0];
+  src           = params[1];
+  rows          = params[2];
+  cols          = params[3];
+  uint64_t ctrl = params[4];
+  uint64_t coef = params[5];
+  ring          = params[6];
+  STENCIL shape = static_cast<STENCIL>( ctrl & 0xff );
+  type          = static_cast<EW_TYPE>( ( ctrl >> 8 ) & 0xff );
+  if( shape > STENCIL::POINT5 || ( type != EW_TYPE::F32 && type != EW_TYPE::F64 ) || ( ctrl >> 16 ) != 0 )
+    parent->output->fatal( CALL_INFO, -1, "Stencil: bad control word 0x%" PRIx64 "\n", ctrl );
+  five  = shape == STENCIL::POINT5;
+  elem  = kernels::elemBytes( type );
+  pitch = params[7] ? params[7] : cols * elem;
+  if( pitch < cols * elem )
+    parent->output->fatal( CALL_INFO, -1, "Stencil: pitch %" PRId64 " is shorter than a row\n", pitch );
+  if( parent->getDecodeInfo( dst ).isIO || parent->getDecodeInfo( src ).isIO )
+    parent->output->fatal( CALL_INFO, -1, "Stencil: source and destination must be DRAM\n" );
+  for( uint64_t a : { coef, ring } ) {
+    auto inf = parent->getDecodeInfo( a );
+    if( !inf.isIO || inf.pimAccType != PIM_ACCESS_TYPE::SRAM )
+      parent->output->fatal( CALL_INFO, -1, "Stencil: coefficients and ring must be in SRAM\n" );
+  }
+
+  if( ring >= SRAM_BASE + SRAM_SIZE )
+    parent->output->fatal( CALL_INFO, -1, "Stencil: ring address 0x%" PRIx64 " is past the end of SRAM\n", ring );
+  // The ring runs to the end of SRAM, so the coefficients sit below it
+  k.resize( ( five ? 5 : 3 ) * elem );
+  if( ( coef - SRAM_BASE ) % SRAM_SIZE + k.size() > ring - SRAM_BASE )
+    parent->output->fatal( CALL_INFO, -1, "Stencil: coefficients at 0x%" PRIx64 " overlap the ring\n", coef );
+
+  const TCLPIMConfig& cfg = parent->getConfig();
+  parent->read( coef, k.size(), k );
+  slotBytes = ( SRAM_BASE + SRAM_SIZE - ring ) / cfg.stencilRows / 8 * 8;
+  if( slotBytes / elem < 3 )
+    parent->output->fatal( CALL_INFO, -1, "Stencil: ring at 0x%" PRIx64 " holds no strip\n", ring );
+  width    = slotBytes / elem - 2;
+  lines    = ( cols + width - 1 ) / width * rows;
+  nextLoad = 0;
+  loadOff  = 0;
+  nextOut  = 0;
+  busy     = 0;
+  slots.assign( cfg.stencilRows, Slot() );
+  assert( writes.empty() && readsInFlight == 0 && writesInFlight == 0 );
+  parent->output->verbose(
+    CALL_INFO, 3, 0, "Stencil: shape=%d type=%d rows=%" PRId64 " cols=%" PRId64 " strip=%" PRId64 " dst=0x%" PRIx64 "\n",
+    static_cast<int>( shape ), static_cast<int>( type ), rows, cols, width, dst
+  );
+}
+
+bool Stencil::clock() {
+  const TCLPIMConfig& cfg = parent->getConfig();
+  if( busy )
+    busy--;
+  if( !busy && writeBytes < 2 * cfg.dmaChunkBytes && ready( nextOut ) ) {
+    if( type == EW_TYPE::F32 )
+      compute<float>();
+    else
+      compute<double>();
+  }
+  load();
+  writeOut();
+  return nextOut == lines && !busy && writes.empty() && writesInFlight == 0 && readsInFlight == 0;
+}
+
+Stencil::Strip Stencil::strip( uint64_t line ) {
+  Strip st;
+  st.c0 = line / rows * width;
+  st.c1 = std::min( st.c0 + width, cols );
+  st.lo = st.c0 ? st.c0 - 1 : 0;
+  st.hi = std::min( st.c1 + 1, cols );
+  return st;
+}
+
+bool Stencil::landed( uint64_t line ) {
+  const Slot& sl = slots[line % slots.size()];
+  return line < nextLoad && sl.line == line && sl.pending == 0;
+}
+
+// An output row needs its input row and, for POINT5, the rows above and
+// below in the same strip
+bool Stencil::ready( uint64_t line ) {
+  if( line >= lines || !landed( line ) )
+    return false;
+  if( !five )
+    return true;
+  uint64_t r = line % rows;
+  return ( r == 0 || landed( line - 1 ) ) && ( r + 1 == rows || landed( line + 1 ) );
+}
+
+// Request one piece of the next line once its ring slot is free. Lines of
+// the next strip load while the last rows of this one are computed.
+void Stencil::load() {
+  const TCLPIMConfig& cfg = parent->getConfig();
+  uint64_t            n   = slots.size();
+  if( nextLoad >= lines || readsInFlight >= cfg.dmaMaxReads )
+    return;
+  // The line in the slot is still needed until the output line after it is computed
+  if( nextLoad + ( five ? 1 : 0 ) >= nextOut + n )
+    return;
+  Strip    st       = strip( nextLoad );
+  uint64_t slot     = nextLoad % n;
+  uint64_t rowBytes = ( st.hi - st.lo ) * elem;
+  slots[slot].line  = nextLoad;
+  slots[slot].pending++;
+  readsInFlight++;
+  uint64_t              to = ring + slot * slotBytes + loadOff;
+  MemEventBase::dataVec d( std::min<uint64_t>( rowBytes - loadOff, cfg.dmaChunkBytes ) );
+  parent->m_issueDRAMRequest(
+    src + nextLoad % rows * pitch + st.lo * elem + loadOff, &d, false,
+    [this, slot, to]( const MemEventBase::dataVec& r ) {
+      MemEventBase::dataVec w( r );
+      parent->write( to, w.size(), &w );
+      slots[slot].pending--;
+      readsInFlight--;
+    }
+  );
+  loadOff += d.size();
+  if( loadOff == rowBytes ) {
+    nextLoad++;
+    loadOff = 0;
+  }
+}
+
+// Compute output line nextOut from the ring and queue its write
+template<typename T>
+void Stencil::compute() {
+  uint64_t r     = nextOut % rows;
+  uint64_t n     = slots.size();
+  Strip    st    = strip( nextOut );
+  uint64_t c0    = st.c0;
+  uint64_t c1    = st.c1;
+  uint64_t lo    = st.lo;
+  uint64_t bytes = ( st.hi - lo ) * elem;
+  auto     row   = [&]( uint64_t i ) {
+    MemEventBase::dataVec d( bytes );
+    parent->read( ring + ( i % n ) * slotBytes, bytes, d );
+    return d;
+  };
+  MemEventBase::dataVec x = row( nextOut );
+  MemEventBase::dataVec y( ( c1 - c0 ) * elem );
+  // Cells without a full neighborhood keep their input value
+  std::memcpy( y.data(), x.data() + ( c0 - lo ) * elem, y.size() );
+  uint64_t i0 = std::max<uint64_t>( c0, 1 );
+  uint64_t i1 = std::min( c1, cols - 1 );
+  if( i0 < i1 && !( five && ( r == 0 || r + 1 == rows ) ) ) {
+    MemEventBase::dataVec north, south;
+    const T*              np = nullptr;
+    const T*              sp = nullptr;
+    if( five ) {
+      north = row( nextOut - 1 );
+      south = row( nextOut + 1 );
+      np    = kernels::elems<const T>( north ) + ( i0 - lo );
+      sp    = kernels::elems<const T>( south ) + ( i0 - lo );
+    }
+    kernels::stencilRow<T>(
+      kernels::elems<const T>( k ), kernels::elems<const T>( x ) + ( i0 - lo ), np, sp,
+      kernels::elems<T>( y ) + ( i0 - c0 ), i1 - i0
+    );
+  }
+
+  const TCLPIMConfig& cfg  = parent->getConfig();
+  uint64_t            addr = dst + r * pitch + c0 * elem;
+  for( uint64_t off = 0; off < y.size(); off += cfg.dmaChunkBytes ) {
+    Write w;
+    w.addr = addr + off;
+    w.data.assign( y.begin() + off, y.begin() + std::min<uint64_t>( y.size(), off + cfg.dmaChunkBytes ) );
+    writes.push_back( w );
+  }
+  writeBytes += y.size();
+  busy = ( c1 - c0 + cfg.stencilLanes - 1 ) / cfg.stencilLanes;
+  nextOut++;
+}
+
+void Stencil::writeOut() {
+  if( writes.empty() || writesInFlight >= parent->getConfig().dmaMaxWrites )
+    return;
+  Write& w = writes.front();
+  writesInFlight++;
+  writeBytes -= w.data.size();
+  parent->m_issueDRAMRequest( w.addr, &w.data, true, [this]( const MemEventBase::dataVec& ) { writesInFlight--; } );
+  writes.pop_front();
+}
+
+Bloom::Bloom( TCLPIM* p, bool probe ) : FSM( p ), probe( probe ), dma( p ), lines( p ), out( p ) {};
+
+// Param 0: Filter Address (DRAM)
+// Param 1: Filter Bits ( power of 2, at least 64 )
+// Param 2: Number of Hash Functions
+// Param 3: Keys Address
+// Param 4: Number of Keys
+// Param 5: Match Bitmap Address (probe)
+// Param 6: Result Address (SRAM, probe, 0 for none)
+
+void Bloom::start( uint64_t params[NUM_FUNC_PARAMS] ) {
+  const char* name = probe ? "BloomProbe" : "BloomBuild";
+  filter           = params[0];
+  bits             = params[1];
+  hashes           = params[2];
+  count            = params[4];
+  uint64_t dst     = params[5];
+  result           = params[6];
+  if( bits < 64 || ( bits & ( bits - 1 ) ) != 0 )
+    parent->output->fatal( CALL_INFO, -1, "%s: %" PRId64 " filter bits is not a power of 2 of at least 64\n", name, bits );
+  if( params[2] == 0 || params[2] > 64 )
+    parent->output->fatal( CALL_INFO, -1, "%s: %" PRId64 " hash functions is not 1 to 64\n", name, params[2] );
+  if( parent->getDecodeInfo( filter ).isIO )
+    parent->output->fatal( CALL_INFO, -1, "%s: filter address 0x%" PRIx64 " must be DRAM\n", name, filter );
+  if( probe ) {
+    auto inf = parent->getDecodeInfo( dst );
+    if( inf.isIO && inf.pimAccType != PIM_ACCESS_TYPE::SRAM )
+      parent->output->fatal( CALL_INFO, -1, "%s: match bitmap must be SRAM or DRAM\n", name );
+    inf = parent->getDecodeInfo( result );
+    if( result && ( !inf.isIO || inf.pimAccType != PIM_ACCESS_TYPE::SRAM ) )
+      parent->output->fatal( CALL_INFO, -1, "%s: result address 0x%" PRIx64 " must be SRAM\n", name, result );
+  }
+
+  lineBytes = std::min<uint64_t>( parent->getConfig().gsBurstBytes, bits / 8 );
+  scanned   = false;
+  retired   = 0;
+  matches   = 0;
+  word      = 0;
+  active    = 0;
+  stagedKeys.clear();
+  assert( pendingBits.empty() && lines.empty() && window.empty() && out.done() );
+  assert( readsInFlight == 0 );
+  if( probe )
+    out.start( dst );
+  parent->output->verbose(
+    CALL_INFO, 3, 0, "%s: filter=0x%" PRIx64 " bits=%" PRId64 " hashes=%u keys=0x%" PRIx64 " count=%" PRId64 "\n", name,
+    filter, bits, hashes, params[3], count
+  );
+  dma.start( DMAEngine::NO_DST, { params[3] }, count * sizeof( uint64_t ), [this]( DMAEngine::Buffers& b ) {
+    const uint64_t* p = kernels::elems<uint64_t>( b[0] );
+    stagedKeys.insert( stagedKeys.end(), p, p + b[0].size() / sizeof( uint64_t ) );
+  }, true );
+}
+
+bool Bloom::clock() {
+  const TCLPIMConfig& cfg = parent->getConfig();
+  if( !scanned && stagedKeys.size() < 2 * cfg.dmaChunkBytes / sizeof( uint64_t ) )
+    scanned = dma.clock();
+  return probe ? probeKeys() : build();
+}
+
+// One key enters per cycle. Its bits are merged into held lines, and at
+// most one missing line is read per cycle.
+bool Bloom::build() {
+  const TCLPIMConfig& cfg = parent->getConfig();
+  if( pendingBits.size() < hashes && !stagedKeys.empty() ) {
+    for( unsigned i = 0; i < hashes; i++ )
+      pendingBits.push_back( bloomBit( stagedKeys.front(), i, bits ) );
+    stagedKeys.pop_front();
+  }
+  bool issued = false;
+  while( !pendingBits.empty() ) {
+    uint64_t         bit  = pendingBits.front();
+    uint64_t         addr = filter + bit / 8 / lineBytes * lineBytes;
+    HeldLines::Line* l    = lines.find( addr );
+    if( !l ) {
+      if( issued || readsInFlight >= cfg.gsMaxOutstanding )
+        break;
+      // Bits set before the read lands are kept in the line and merged then
+      l = &lines.hold( addr, lineBytes );
+      MemEventBase::dataVec d( lineBytes );
+      readsInFlight++;
+      parent->m_issueDRAMRequest( addr, &d, false, [this, addr]( const MemEventBase::dataVec& r ) {
+        readsInFlight--;
+        HeldLines::Line& rl    = *lines.find( addr );
+        bool             dirty = false;
+        for( size_t i = 0; i < r.size(); i++ ) {
+          dirty = dirty || ( rl.data[i] & ~r[i] );
+          rl.data[i] |= r[i];
+        }
+        rl.valid = true;
+        if( dirty )
+          lines.changed( addr, rl );
+        else
+          lines.release( addr );
       } );
+      issued = true;
     }
-    dst += bytes;
-    dma_state = DMA_STATE::WAITING;
-  } else if( dma_state == DMA_STATE::DONE ) {
-    parent->output->verbose( CALL_INFO, 1, 0, "DMA Done\n" );
-    dma_state = DMA_STATE::IDLE;
-    return true;  // finished!
+    setBit( addr, *l, bit );
+    pendingBits.pop_front();
   }
-  return false;
+  lines.writeBack();
+  return scanned && stagedKeys.empty() && pendingBits.empty() && lines.empty() && readsInFlight == 0;
+}
+
+void Bloom::setBit( uint64_t addr, HeldLines::Line& l, uint64_t bit ) {
+  uint8_t& b    = l.data[bit / 8 % lineBytes];
+  uint8_t  mask = uint8_t( 1 << ( bit % 8 ) );
+  if( b & mask )
+    return;
+  b |= mask;
+  lines.changed( addr, l );
+}
+
+bool Bloom::probeKeys() {
+  const TCLPIMConfig& cfg = parent->getConfig();
+  // Finished probes wait in the window for older ones without holding a slot
+  while( active < cfg.hashMaxProbes && window.size() < 8 * cfg.hashMaxProbes && !stagedKeys.empty() ) {
+    Probe pr;
+    pr.key = stagedKeys.front();
+    stagedKeys.pop_front();
+    window.push_back( pr );
+    active++;
+  }
+  // The oldest waiting probe gets the read, so results retire sooner
+  for( auto& pr : window ) {
+    if( pr.ready ) {
+      issue( pr );
+      break;
+    }
+  }
+  for( ; !window.empty() && window.front().done; window.pop_front(), retired++ ) {
+    if( window.front().match ) {
+      word |= 1ull << ( retired % 64 );
+      matches++;
+    }
+    if( retired % 64 == 63 ) {
+      out.push( word );
+      word = 0;
+    }
+  }
+  bool probed = scanned && stagedKeys.empty() && window.empty();
+  if( probed && retired % 64 ) {
+    out.push( word );
+    word    = 0;
+    retired = retired / 64 * 64 + 64;
+  }
+  out.flush( probed );
+  if( !probed || !out.done() )
+    return false;
+  if( result ) {
+    MemEventBase::dataVec d( sizeof( matches ) );
+    std::memcpy( d.data(), &matches, sizeof( matches ) );
+    parent->write( result, d.size(), &d );
+  }
+  return true;
+}
+
+// Read the filter word holding the next bit of a probe
+void Bloom::issue( Probe& pr ) {
+  uint64_t              bit = bloomBit( pr.key, pr.hash, bits );
+  Probe*                pp  = &pr;
+  MemEventBase::dataVec d( sizeof( uint64_t ) );
+  pr.ready = false;
+  parent->m_issueDRAMRequest( filter + bit / 64 * sizeof( uint64_t ), &d, false, [this, pp, bit]( const MemEventBase::dataVec& r ) {
+    uint64_t w;
+    std::memcpy( &w, r.data(), sizeof( w ) );
+    if( !( ( w >> ( bit % 64 ) ) & 1 ) ) {
+      pp->done = true;
+    } else if( ++pp->hash == hashes ) {
+      pp->done  = true;
+      pp->match = true;
+    } else {
+      pp->ready = true;
+    }
+    if( pp->done )
+      active--;
+  } );
+}
+
+MulVecByScalar::MulVecByScalar( TCLPIM* p ) : FSM( p ), dma( p ) {};
+
+// Param 0: Destination Address
+// Param 1: Source Address
+// Param 2: Scalar
+// Param 3: Number of Bytes ( must by divisible by 8 )
+
+void MulVecByScalar::start( uint64_t params[NUM_FUNC_PARAMS] ) {
+  uint64_t numBytes = params[3];
+  assert((numBytes%8)==0);
+  uint64_t scalar = params[2];
+  parent->output->verbose(
+    CALL_INFO, 3, 0, 
+    "MulVecByScalar: dst=0x%" PRIx64 " src=0x%" PRIx64 "scalar=%" PRId64 " total_words=%" PRId64 "\n", 
+    params[0], params[1], scalar, numBytes/8);
+  dma.start( params[0], { params[1] }, numBytes, [scalar]( DMAEngine::Buffers& b ) {
+    kernels::elementWise<uint64_t>( EW_OP::SCALE, scalar, b );
+  } );
+}
+
+bool MulVecByScalar::clock() {
+  if( !dma.clock() )
+    return false;
+  parent->output->verbose( CALL_INFO, 1, 0, "DMA Done\n" );
+  return true;  // finished!
 }
 
-} // namespace
\ No newline at end of file
+} // namespace
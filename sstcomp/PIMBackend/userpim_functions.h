@@ -9,22 +9,615 @@
 #define _SST_PIMBACKEND_USER_PIM_FUNCTIONS_
 
 #include "tclpim.h"
+#include "tclpim_dma.h"
+#include "tclpim_kernels.h"
 
 namespace SST::PIM {
 
+// Function FSMs keep the state of in-flight requests in std::deque entries
+// and hand completions a pointer to the entry. Pushing and popping at the
+// ends of a deque leaves the other entries in place, so the pointer stays
+// good as long as an entry is only popped once its requests complete.
+
+// DRAM lines a function FSM holds between the read that fetched them and the
+// write-back of their last change. A held line is newer than memory, so the
+// FSM looks here before reading. A line changed while its write is in flight
+// is queued again once that write completes, so no two writes to a line race.
+// One changed line is written per cycle, with up to dmaMaxWrites in flight.
+class HeldLines {
+public:
+  struct Line {
+    MemEventBase::dataVec data;
+    bool                  valid   = false;  // read has landed
+    bool                  queued  = false;  // changed since the last write issued
+    bool                  writing = false;
+  };
+  HeldLines( TCLPIM* p );
+  Line* find( uint64_t addr );                  // nullptr when not held
+  Line& hold( uint64_t addr, uint64_t bytes );  // zeroed line, not yet valid
+  void  changed( uint64_t addr, Line& l );      // queue a valid line for write-back
+  void  release( uint64_t addr );               // drop a line with no write outstanding
+  // otherWrites: writes the owning FSM has in flight under the same cap
+  void     writeBack( unsigned otherWrites = 0 );
+  bool     empty() const { return lines.empty(); }
+  unsigned writes() const { return writesInFlight; }
+
+private:
+  TCLPIM*                  parent;
+  std::map<uint64_t, Line> lines;
+  std::deque<uint64_t>     toWrite;
+  unsigned                 writesInFlight = 0;
+};  //class HeldLines
+
+// Typed element-wise kernels, see EW_OP in pimdef.h
+class ElementWise : public FSM {
+public:
+  ElementWise( TCLPIM* p );
+  void start( uint64_t params[NUM_FUNC_PARAMS] ) override;
+  bool clock() override;
+private:
+  DMAEngine dma;
+};  //class ElementWise
+
+// Reduction of one vector (two for DOT) to a scalar in SRAM, see RED_OP
+class Reduce : public FSM {
+public:
+  Reduce( TCLPIM* p );
+  void start( uint64_t params[NUM_FUNC_PARAMS] ) override;
+  bool clock() override;
+private:
+  DMAEngine dma;
+  RED_OP    op     = RED_OP::SUM;
+  uint64_t  result = 0;  // SRAM result address
+  uint64_t  value  = 0;
+  uint64_t  index  = 0;
+};  //class Reduce
+
+// Inclusive or exclusive prefix scan
+class Scan : public FSM {
+public:
+  Scan( TCLPIM* p );
+  void start( uint64_t params[NUM_FUNC_PARAMS] ) override;
+  bool clock() override;
+private:
+  DMAEngine dma;
+};  //class Scan
+
+// Linked structure walk, see chaseCtrl in pimdef.h. Each hop is one
+// dependent read of the node bytes that are needed.
+class PointerChase : public FSM {
+public:
+  PointerChase( TCLPIM* p );
+  void start( uint64_t params[NUM_FUNC_PARAMS] ) override;
+  bool clock() override;
+private:
+  enum class STATE { IDLE, FETCH, WAIT, DONE };
+  STATE    state        = STATE::IDLE;
+  uint64_t result       = 0;  // SRAM result address
+  uint64_t node         = 0;  // node being visited
+  uint64_t nextOff      = 0;
+  uint64_t maxHops      = 0;
+  uint64_t keyOff       = 0;
+  uint64_t key          = 0;
+  bool     match        = false;
+  uint64_t payloadOff   = 0;
+  unsigned payloadBytes = 0;
+  uint64_t spanLo       = 0;  // node bytes fetched per hop
+  uint64_t spanBytes    = 0;
+  uint64_t hops         = 0;
+  void     fetch();
+  void     visit();
+  uint64_t field( uint64_t off );
+  void     finish( uint64_t found );
+};  //class PointerChase
+
+// Batched hash table lookup, see HASH_MODE in pimdef.h. Up to
+// hashMaxProbes keys walk the table at once, one table read per cycle.
+class HashProbe : public FSM {
+public:
+  HashProbe( TCLPIM* p );
+  void start( uint64_t params[NUM_FUNC_PARAMS] ) override;
+  bool clock() override;
+private:
+  enum class STEP { BUCKET, NODE };
+  struct Probe {
+    bool                  active = false;
+    bool                  ready  = false;  // next table read may issue
+    STEP                  step   = STEP::BUCKET;
+    uint64_t              i      = 0;  // key number
+    uint64_t              key    = 0;
+    uint64_t              bucket = 0;  // current bucket (OPEN)
+    uint64_t              probes = 0;  // buckets visited (OPEN)
+    uint64_t              addr   = 0;  // next table read
+    MemEventBase::dataVec data;
+  };
+  std::vector<Probe> probes;
+  HASH_MODE          mode       = HASH_MODE::OPEN;
+  uint64_t           values     = 0;
+  uint64_t           keys       = 0;
+  uint64_t           numKeys    = 0;
+  uint64_t           table      = 0;
+  uint64_t           numBuckets = 0;
+  uint64_t           emptyKey   = 0;
+  uint64_t           missValue  = 0;
+  uint64_t           nextKey    = 0;  // next key to admit
+  unsigned           nextIssue  = 0;  // round robin issue pointer
+  void     admit( Probe& pr );
+  void     issue( unsigned pi );
+  void     probed( Probe& pr );
+  void     finish( Probe& pr, uint64_t value );
+  uint64_t word( const Probe& pr, unsigned w );
+};  //class HashProbe
+
+// Sort of 64-bit keys or {key, value} records, see sortCtrl in pimdef.h.
+// Tiles are sorted in the SRAM scratchpad, then runs are merged pairwise
+// between DRAM buffers, one streaming merge at a time.
+class Sort : public FSM {
+public:
+  Sort( TCLPIM* p );
+  void start( uint64_t params[NUM_FUNC_PARAMS] ) override;
+  bool clock() override;
+private:
+  enum class PHASE { IDLE, LOAD, SORT, STORE, MERGE };
+  struct Input {
+    uint64_t              addr    = 0;  // next byte to fetch
+    uint64_t              left    = 0;  // bytes not yet fetched
+    bool                  pending = false;
+    size_t                pos     = 0;  // first unconsumed byte of data
+    MemEventBase::dataVec data;
+  };
+  DMAEngine             dma;
+  PHASE                 phase     = PHASE::IDLE;
+  SORT_NET              net       = SORT_NET::BITONIC;
+  unsigned              recBytes  = 8;
+  uint64_t              dst       = 0;
+  uint64_t              src       = 0;
+  uint64_t              tmp       = 0;
+  uint64_t              count     = 0;  // records
+  uint64_t              tile      = 0;  // SRAM tile address
+  uint64_t              tileRecs  = 0;  // records per tile
+  uint64_t              tileIdx   = 0;
+  uint64_t              tileBase  = 0;  // first buffer written by the tile phase
+  uint64_t              stall     = 0;  // modeled tile sort cycles left
+  uint64_t              runRecs   = 0;  // records per sorted run
+  uint64_t              from      = 0;  // merge pass source buffer
+  uint64_t              to        = 0;  // merge pass destination buffer
+  uint64_t              pairBase  = 0;  // first record of the pair being merged
+  Input                 in[2];
+  uint64_t              chunk     = 0;  // merge read and write size, whole records
+  OutStream             out;            // merged records
+  uint64_t tileCount();
+  uint64_t networkCycles( uint64_t n );
+  void     sortTile();
+  void     startPair();
+  bool     merge();
+  void     fetch( unsigned i );
+  bool     drained( const Input& in );
+  uint64_t key( const Input& in );
+};  //class Sort
+
+// Predicate scan with stream compaction, see FILTER_OP in pimdef.h.
+// Matches are packed in order and written out in DMA chunk sized pieces.
+class Filter : public FSM {
+public:
+  Filter( TCLPIM* p );
+  void start( uint64_t params[NUM_FUNC_PARAMS] ) override;
+  bool clock() override;
+private:
+  DMAEngine             dma;
+  uint64_t              result  = 0;  // SRAM count address
+  uint64_t              matches = 0;
+  bool                  scanned = false;
+  OutStream             out;  // packed matches
+};  //class Filter
+
+// Histogram and group-by aggregation into SRAM bins, see HIST_OP in pimdef.h.
+// Bins that do not fit the SRAM window are cached a gsBurstBytes line at a
+// time. An evicted line is added into dst by a read-modify-write, and a
+// line never has two of those in flight.
+class Histogram : public FSM {
+public:
+  Histogram( TCLPIM* p );
+  void start( uint64_t params[NUM_FUNC_PARAMS] ) override;
+  bool clock() override;
+private:
+  enum class PHASE { IDLE, CLEAR, SCAN, FLUSH, DRAIN };
+  enum class SPILL_STATE { FREE, READING, READY, WRITING };
+  static constexpr uint64_t NO_LINE = ~0ull;
+  struct Spill {
+    SPILL_STATE           state = SPILL_STATE::FREE;
+    uint64_t              line  = NO_LINE;
+    MemEventBase::dataVec partial;  // evicted SRAM aggregates
+    MemEventBase::dataVec data;     // dst line being updated
+  };
+  DMAEngine             dma;
+  PHASE                 phase    = PHASE::IDLE;
+  HIST_OP               op       = HIST_OP::COUNT;
+  unsigned              shift    = 0;
+  uint64_t              dst      = 0;
+  uint64_t              keys     = 0;
+  uint64_t              values   = 0;
+  uint64_t              count    = 0;  // records
+  uint64_t              bins     = 0;
+  uint64_t              window   = 0;  // SRAM bin address
+  bool                  resident = true;  // every bin has its own SRAM word
+  uint64_t              lineBins = 0;
+  std::vector<uint64_t> tags;  // line held by each SRAM slot when cached
+  std::vector<Spill>    spills;
+  std::vector<uint64_t> stagedKeys;
+  std::vector<uint64_t> stagedValues;
+  size_t                head      = 0;  // next staged record
+  uint64_t              flushSlot = 0;
+  std::vector<uint8_t>  zeros;
+  bool     update( uint64_t key, uint64_t value );
+  bool     evict( uint64_t slot );
+  void     issueSpills();
+  uint64_t lineBytes( uint64_t line );
+  void     startScan();
+};  //class Histogram
+
+// CSR sparse matrix-vector multiply, see pimdef.h. Nonzeros stream in
+// through the DMA engine and wait in a window of spmvWindow entries for
+// their x values. Missing x lines are fetched gsBurstBytes at a time, up to
+// gsMaxOutstanding at once, and fill a direct mapped x cache in SRAM.
+// Entries retire in CSR order so row sums are reproducible.
+class SpMV : public FSM {
+public:
+  SpMV( TCLPIM* p );
+  void start( uint64_t params[NUM_FUNC_PARAMS] ) override;
+  bool clock() override;
+private:
+  enum class PHASE { IDLE, ROWS, NNZ, FLUSH };
+  struct Entry {
+    uint64_t row   = 0;  // block relative
+    uint64_t line  = 0;  // x line address
+    uint64_t off   = 0;  // x byte offset in the line
+    double   val   = 0;
+    double   x     = 0;
+    bool     ready = false;
+  };
+  DMAEngine             dma;
+  PHASE                 phase   = PHASE::IDLE;
+  uint64_t              y       = 0;
+  uint64_t              rowPtr  = 0;
+  uint64_t              colIdx  = 0;
+  uint64_t              values  = 0;
+  uint64_t              x       = 0;
+  uint64_t              rows    = 0;
+  uint64_t              acc     = 0;  // SRAM row sums
+  uint64_t              accRows = 0;
+  uint64_t              cache   = 0;  // SRAM x cache
+  std::vector<uint64_t> tags;
+  uint64_t              r0      = 0;  // first row of the block
+  uint64_t              nr      = 0;  // rows in the block
+  std::vector<uint64_t> ptr;          // row_ptr of the block
+  std::vector<uint64_t> stagedCols;
+  std::vector<double>   stagedVals;
+  size_t                head    = 0;  // next staged nonzero
+  uint64_t              nextK   = 0;  // nonzero number of head
+  uint64_t              curRow  = 0;
+  std::deque<Entry>     window;
+  std::set<uint64_t>    missing;  // x lines queued or being read
+  std::deque<uint64_t>  toFetch;
+  unsigned              readsInFlight = 0;
+  void startBlock();
+  void startNonzeros();
+  void admit();
+  void fetch();
+  void filled( uint64_t line, const MemEventBase::dataVec& d );
+  void retire();
+};  //class SpMV
+
+// GEMV / small GEMM, see gemvCtrl in pimdef.h. B stays in SRAM while
+// batches of weight rows stream into two ping-pong buffers, so the load of
+// one batch overlaps the modeled compute on the other.
+class Gemv : public FSM {
+public:
+  Gemv( TCLPIM* p );
+  void start( uint64_t params[NUM_FUNC_PARAMS] ) override;
+  bool clock() override;
+private:
+  enum class BUF_STATE { EMPTY, LOADING, FULL };
+  struct Buffer {
+    BUF_STATE             state = BUF_STATE::EMPTY;
+    uint64_t              row0  = 0;
+    uint64_t              rows  = 0;
+    MemEventBase::dataVec data;
+  };
+  DMAEngine             loads[2];
+  Buffer                bufs[2];
+  unsigned              cur        = 0;  // buffer computed next
+  EW_TYPE               type       = EW_TYPE::F32;
+  uint64_t              y          = 0;
+  uint64_t              w          = 0;
+  uint64_t              rows       = 0;
+  uint64_t              cols       = 0;
+  uint64_t              n          = 1;
+  uint64_t              pitch      = 0;
+  uint64_t              batchRows  = 0;
+  uint64_t              nextRow    = 0;  // next row to load
+  MemEventBase::dataVec b;                // copy of the SRAM operand
+  MemEventBase::dataVec result;           // Y rows of the batch being computed
+  OutStream             out;              // Y
+  uint64_t              busy       = 0;   // modeled compute cycles left
+  uint64_t              stalls     = 0;   // cycles compute waited on a load
+  void startLoad( unsigned i );
+  void compute( Buffer& buf );
+};  //class Gemv
+
+// Delta + bit-pack compression and decompression, see CODEC_BLOCK_WORDS in
+// pimdef.h. The input streams in order into a staging buffer and is coded a
+// block at a time. Each block holds the codec for codecBlockCycles plus one
+// cycle per codecEncodeWords (codecDecodeWords) words while the next input
+// chunks load and coded output drains to dst.
+class Codec : public FSM {
+public:
+  Codec( TCLPIM* p, bool decompress );
+  void start( uint64_t params[NUM_FUNC_PARAMS] ) override;
+  bool clock() override;
+private:
+  bool                  decompress;
+  DMAEngine             dma;
+  uint64_t              result  = 0;  // SRAM address of the output byte count
+  bool                  scanned = false;
+  MemEventBase::dataVec in;        // input not yet coded
+  OutStream             out;       // coded output
+  uint64_t              busy = 0;  // modeled codec cycles left
+  void                  code();
+};  //class Codec
+
+// Embedding bag sparse-lengths-sum, see slsCtrl in pimdef.h. Indices and
+// lengths stream in through their own DMA engines. Table rows are fetched
+// in dmaChunkBytes pieces with up to gsMaxOutstanding requests in flight,
+// and pooled in index order into the SRAM accumulator at slsLanes elements
+// per cycle, so bag sums are reproducible.
+class SLS : public FSM {
+public:
+  SLS( TCLPIM* p );
+  void start( uint64_t params[NUM_FUNC_PARAMS] ) override;
+  bool clock() override;
+private:
+  struct Entry {
+    uint64_t              bag     = 0;
+    bool                  last    = false;  // last row of the bag
+    bool                  empty   = false;  // bag with no rows
+    uint64_t              addr    = 0;
+    uint64_t              issued  = 0;  // row bytes requested so far
+    unsigned              pending = 0;  // row pieces in flight
+    MemEventBase::dataVec data;
+  };
+  DMAEngine             idxDma;
+  DMAEngine             lenDma;
+  EW_TYPE               type      = EW_TYPE::F32;
+  uint64_t              table     = 0;
+  uint64_t              bags      = 0;
+  uint64_t              dim       = 0;
+  uint64_t              acc       = 0;  // SRAM accumulator
+  uint64_t              rowBytes  = 0;
+  uint64_t              pitch     = 0;
+  uint64_t              idxAddr   = 0;  // next index to request
+  uint64_t              idxWanted = 0;  // indices counted in lengths, not yet requested
+  std::deque<uint64_t>  stagedIdx;
+  std::deque<uint64_t>  stagedLen;
+  uint64_t              nextBag   = 0;  // next bag to admit
+  uint64_t              remaining = 0;  // rows of the admitted bag not yet admitted
+  std::deque<Entry>     window;
+  unsigned              outstanding    = 0;      // row piece reads in flight
+  uint64_t              busy           = 0;      // modeled pooling cycles left
+  uint64_t              retiredBag     = ~0ull;  // bag in the accumulator
+  bool                  bagDone        = false;  // accumulator holds a finished bag
+  OutStream             pooled;                  // finished bags
+  void admit();
+  void issue( Entry& e );
+  void retire();
+  void writeBag();
+};  //class SLS
+
+// One graph frontier step, see BFS_MODE in pimdef.h. Frontier vertices
+// stream in through the DMA engine and their row_ptr pairs and edge lists
+// are read with up to gsMaxOutstanding requests in flight, one read issued
+// per cycle. Neighbor updates apply one per cycle and are combined into the
+// state words the PIM holds, see HeldLines.
+class Frontier : public FSM {
+public:
+  Frontier( TCLPIM* p );
+  void start( uint64_t params[NUM_FUNC_PARAMS] ) override;
+  bool clock() override;
+private:
+  struct Vertex {
+    uint64_t u        = 0;
+    uint64_t dist     = 0;      // RELAX
+    uint64_t begin    = 0;      // next edge to request
+    uint64_t end      = 0;
+    bool     needDist = false;  // RELAX distance not yet requested
+    unsigned pending  = 0;      // row_ptr and distance reads in flight
+  };
+  struct Update {
+    uint64_t v    = 0;
+    uint64_t word = 0;  // state word address
+    uint64_t val  = 0;  // bit, level or candidate distance
+  };
+  using Updates = std::vector<Update>;
+  DMAEngine                   dma;
+  BFS_MODE                    mode      = BFS_MODE::VISIT;
+  uint64_t                    level     = 0;
+  uint64_t                    rowPtr    = 0;
+  uint64_t                    colIdx    = 0;
+  uint64_t                    state     = 0;
+  uint64_t                    result    = 0;
+  uint64_t                    edgeBytes = 0;
+  uint64_t                    found     = 0;  // next frontier size
+  uint64_t                    edges     = 0;  // edges visited
+  bool                        scanned   = false;
+  std::deque<uint64_t>        stagedFrontier;
+  std::deque<Vertex>          vertices;
+  std::deque<Update>          updates;
+  HeldLines                   words;    // state words
+  std::map<uint64_t, Updates> waiting;  // updates that arrived during a word's read
+  std::set<uint64_t>          emitted;  // RELAX
+  OutStream                   out;      // next frontier
+  unsigned                    readsInFlight = 0;
+  void read( uint64_t addr, uint64_t bytes, std::function<void( const MemEventBase::dataVec& )> done );
+  bool readVertex();
+  bool readEdges();
+  void expand( const MemEventBase::dataVec& d, uint64_t dist );
+  bool update();
+  void apply( uint64_t addr, HeldLines::Line& w, const Update& up );
+};  //class Frontier
+
+// Bitmap index AND/OR/XOR/ANDNOT with popcount, see BITMAP_OP in pimdef.h.
+// The sources stream through the DMA engine together and each chunk is
+// folded 64-bit words at a time before it is written out.
+class Bitmap : public FSM {
+public:
+  Bitmap( TCLPIM* p );
+  void start( uint64_t params[NUM_FUNC_PARAMS] ) override;
+  bool clock() override;
+private:
+  DMAEngine dma;
+  uint64_t  result = 0;
+  uint64_t  count  = 0;
+};  //class Bitmap
+
+// CRC-32C and xxHash64 digests and block verification, see CSUM_ALG in
+// pimdef.h. The range streams through the DMA engine in order. To verify,
+// the stored checksums stream through a second engine and block digests are
+// compared as both arrive.
+class Checksum : public FSM {
+public:
+  Checksum( TCLPIM* p );
+  void start( uint64_t params[NUM_FUNC_PARAMS] ) override;
+  bool clock() override;
+private:
+  DMAEngine             dma;
+  DMAEngine             sumDma;
+  kernels::Hasher       hasher;
+  CSUM_ALG              alg        = CSUM_ALG::CRC32C;
+  bool                  verify     = false;
+  bool                  scanned    = false;
+  uint64_t              seed       = 0;
+  uint64_t              result     = 0;
+  uint64_t              blockBytes = 0;
+  uint64_t              blockFill  = 0;  // bytes hashed into the current block
+  uint64_t              blocks     = 0;
+  uint64_t              block      = 0;  // next block to compare
+  uint64_t              mismatches = 0;
+  std::deque<uint64_t>  digests;     // block digests not yet compared
+  std::deque<uint64_t>  stagedSums;  // stored checksums not yet compared
+  bool                  indices    = false;  // write mismatching block indices to out
+  OutStream             out;
+  void hashBlocks( const MemEventBase::dataVec& d );
+};  //class Checksum
+
+// 3 and 5 point stencils, see STENCIL in pimdef.h. The grid is cut into
+// column strips with a halo column on each side, and the strip rows are
+// read in order, strip after strip, into a ring of stencilRows SRAM rows
+// with up to dmaMaxReads requests in flight. Each output row is computed
+// from the ring rows around it at stencilLanes outputs per cycle, so an
+// input row is read once per strip and used by up to three output rows.
+class Stencil : public FSM {
+public:
+  Stencil( TCLPIM* p );
+  void start( uint64_t params[NUM_FUNC_PARAMS] ) override;
+  bool clock() override;
+private:
+  static constexpr uint64_t NO_LINE = ~0ull;
+  struct Slot {
+    uint64_t line    = NO_LINE;
+    unsigned pending = 0;  // row pieces in flight
+  };
+  struct Strip {
+    uint64_t c0 = 0;  // output columns [c0, c1)
+    uint64_t c1 = 0;
+    uint64_t lo = 0;  // input columns [lo, hi)
+    uint64_t hi = 0;
+  };
+  struct Write {
+    uint64_t              addr = 0;
+    MemEventBase::dataVec data;
+  };
+  EW_TYPE               type      = EW_TYPE::F32;
+  bool                  five      = false;  // POINT5
+  uint64_t              dst       = 0;
+  uint64_t              src       = 0;
+  uint64_t              rows      = 0;
+  uint64_t              cols      = 0;
+  uint64_t              pitch     = 0;
+  uint64_t              elem      = 0;  // element bytes
+  MemEventBase::dataVec k;              // coefficients
+  uint64_t              ring      = 0;  // SRAM ring address
+  uint64_t              slotBytes = 0;
+  uint64_t              width     = 0;  // output columns per strip
+  uint64_t              lines     = 0;  // strip rows, row r of strip s is line s * rows + r
+  std::vector<Slot>     slots;
+  uint64_t              nextLoad  = 0;  // line being requested
+  uint64_t              loadOff   = 0;  // bytes of it requested
+  uint64_t              nextOut   = 0;  // line computed next
+  uint64_t              busy      = 0;  // modeled compute cycles left
+  std::deque<Write>     writes;
+  uint64_t              writeBytes     = 0;  // queued, not yet issued
+  unsigned              readsInFlight  = 0;
+  unsigned              writesInFlight = 0;
+  Strip strip( uint64_t line );
+  bool  landed( uint64_t line );
+  bool  ready( uint64_t line );
+  void  load();
+  template<typename T>
+  void compute();
+  void writeOut();
+};  //class Stencil
+
+// Bloom filter build and batch probe, see bloomBit in pimdef.h. Keys stream
+// in through the DMA engine. Build sets key bits in gsBurstBytes lines of the
+// filter that the PIM holds, see HeldLines. Probe keeps up to hashMaxProbes
+// keys reading the filter, each testing one filter word at a time and
+// stopping at the first clear bit, with one read issued per cycle. Probe
+// results retire in key order.
+class Bloom : public FSM {
+public:
+  Bloom( TCLPIM* p, bool probe );
+  void start( uint64_t params[NUM_FUNC_PARAMS] ) override;
+  bool clock() override;
+private:
+  struct Probe {
+    uint64_t key   = 0;
+    unsigned hash  = 0;  // next hash function to test
+    bool     ready = true;
+    bool     done  = false;
+    bool     match = false;
+  };
+  bool                     probe;
+  DMAEngine                dma;
+  uint64_t                 filter    = 0;
+  uint64_t                 bits      = 0;
+  unsigned                 hashes    = 0;
+  uint64_t                 count     = 0;  // keys
+  uint64_t                 result    = 0;
+  uint64_t                 lineBytes = 0;
+  bool                     scanned   = false;
+  std::deque<uint64_t>     stagedKeys;
+  std::deque<uint64_t>     pendingBits;  // build bits not yet applied
+  HeldLines                lines;        // filter lines
+  std::deque<Probe>        window;
+  unsigned                 active    = 0;  // probes still reading the filter
+  uint64_t                 retired   = 0;
+  uint64_t                 matches   = 0;
+  uint64_t                 word      = 0;  // match bits not yet packed into out
+  OutStream                out;            // match bitmap
+  unsigned                 readsInFlight = 0;
+  bool build();
+  void setBit( uint64_t addr, HeldLines::Line& l, uint64_t bit );
+  bool probeKeys();
+  void issue( Probe& pr );
+};  //class Bloom
+
 class MulVecByScalar : public FSM {
 public:
   MulVecByScalar( TCLPIM* p );
   void start( uint64_t params[NUM_FUNC_PARAMS] ) override;
   bool clock() override;
 private:
-  enum DMA_STATE { IDLE, READ, WRITE, WAITING, DONE };
-  DMA_STATE dma_state    = DMA_STATE::IDLE;
-  uint64_t  total_words  = 0;
-  uint64_t  word_counter = 0;
-  uint64_t  src          = 0;
-  uint64_t  dst          = 0;
-  uint64_t  scalar       = 0;
+  DMAEngine dma;
 };  //class MulVecByScalar
 
 } // namespace SST::PIM
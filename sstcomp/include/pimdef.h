@@ -12,13 +12,20 @@ namespace SST::PIM
 {    
     // Important: Keep memory map in sync with pim.lds
 
-    // 16 built-in functions
-    const uint64_t FUNC_SIZE = 0x00000010llu;
+    // 32 functions: 8 built-in (F0-F7) and 24 user (U0-U23), one 64-bit
+    // register each. User functions share this window with the built-ins.
+    // It grew from 16 slots once U0-U7 were taken, and 0x0e000000-0x0e0000ff
+    // still ends below the control registers.
+    const uint64_t FUNC_SIZE = 0x00000020llu;
     const uint64_t FUNC_BASE = 0x0e000000llu;
 
-    // 16 user functions
-    const uint64_t USRFUNC_SIZE = 0x00000010llu;
-    const uint64_t USRFUNC_BASE = 0x0e000100llu;
+    // 32 blocking function status registers. Reads respond once the function is no longer running.
+    const uint64_t FUNC_WAIT_SIZE = FUNC_SIZE;
+    const uint64_t FUNC_WAIT_BASE = 0x0e000300llu;
+
+    // 16 control registers
+    const uint64_t CTRL_SIZE = 0x00000010llu;
+    const uint64_t CTRL_BASE = 0x0e000200llu;
 
     // 1k sram
     const uint64_t SRAM_SIZE = 0x00000400llu;
@@ -35,10 +42,12 @@ namespace SST::PIM
     enum class FUNC_CMD : int { INIT, RUN, FINISH };
 
     // Function ID Convenience
-    const unsigned NUM_FUNCS = 16;
+    const unsigned NUM_FUNCS = 32;
     enum class FUNC_NUM    : int { 
         F0, F1, F2, F3, F4, F5, F6, F7, 
-        U0, U1, U2, U3, U4, U5, U6, U7
+        U0, U1, U2, U3, U4, U5, U6, U7,
+        U8, U9, U10, U11, U12, U13, U14, U15,
+        U16, U17, U18, U19, U20, U21, U22, U23
     };
     
     // Number of funtion params to send on init
@@ -47,6 +56,272 @@ namespace SST::PIM
     // Function states
     enum class FSTATE  : int { INVALID, INITIALIZING, READY, RUNNING, DONE };
 
+    // Control registers
+    //   RING_BASE: SRAM address of the descriptor ring (resets head and tail)
+    //   RING_SIZE: ring size in 64-bit words (resets head and tail)
+    //   RING_HEAD: producer index in words. Host writes it as the doorbell.
+    //   RING_TAIL: consumer index in words. Advanced by the PIM (read only).
+    //   RING_WAIT: blocking read of RING_TAIL. Responds once the ring is drained
+    //              and no function is running.
+    enum class CTRL_REG : int { RING_BASE, RING_SIZE, RING_HEAD, RING_TAIL, RING_WAIT };
+
+    // Descriptor ring entry: a header word followed by nargs parameters.
+    //   header[7:0]   function number
+    //   header[15:8]  number of parameters (<= NUM_FUNC_PARAMS, rest are 0)
+    //   header[31:16] completion slot: SRAM dword index written with
+    //                 FSTATE::DONE when the function finishes (0 for none)
+    //   header[32]    a dependency mask word follows the header. Bit i makes
+    //                 the entry wait for the descriptor i+1 entries earlier.
+    const unsigned DESC_FNUM_SHIFT  = 0;
+    const unsigned DESC_NARGS_SHIFT = 8;
+    const unsigned DESC_CPL_SHIFT   = 16;
+    const uint64_t DESC_DEPS_FLAG   = 1ull << 32;
+
+    inline constexpr uint64_t descHeader( FUNC_NUM f, unsigned nargs, unsigned cpl_slot, bool deps = false ) {
+        return ( uint64_t( static_cast<unsigned>( f ) & 0xff ) << DESC_FNUM_SHIFT ) |
+               ( uint64_t( nargs & 0xff ) << DESC_NARGS_SHIFT ) |
+               ( uint64_t( cpl_slot & 0xffff ) << DESC_CPL_SHIFT ) |
+               ( deps ? DESC_DEPS_FLAG : 0 );
+    }
+
+    // Element-wise kernels (user function U0)
+    //   params: dst, srcA, srcB, srcC, ewCtrl(op,type), alpha, numBytes
+    //   ADD/SUB/MUL/MIN/MAX: dst = A op B
+    //   SCALE:               dst = alpha * A
+    //   AXPY:                dst = alpha * A + B
+    //   CMPEQ/CMPLT:         dst = A op B ? all ones : 0 (same element width)
+    //   SELECT:              dst = C != 0 ? A : B (C holds masks of the same width)
+    // alpha holds the element bit pattern in its low bytes. Integer arithmetic wraps.
+    enum class EW_OP   : int { ADD, SUB, MUL, SCALE, AXPY, MIN, MAX, CMPEQ, CMPLT, SELECT };
+    enum class EW_TYPE : int { I8, I16, I32, I64, U8, U16, U32, U64, F32, F64 };
+
+    inline constexpr uint64_t ewCtrl( EW_OP op, EW_TYPE type ) {
+        return ( uint64_t( static_cast<unsigned>( type ) & 0xff ) << 8 ) | ( static_cast<unsigned>( op ) & 0xff );
+    }
+
+    // Reductions (user function U1) and prefix scans (user function U2)
+    //   U1 params: result (SRAM), srcA, srcB (DOT), redCtrl(op,type), numBytes
+    //   U2 params: dst, src, redCtrl(op,type,exclusive), numBytes
+    // Reduction results are 64-bit: integers widen (sums wrap), floats are fp64.
+    // ARGMAX also writes the index of the first maximum to result+8.
+    // An empty MIN/MAX/ARGMAX yields 0 with index ~0. Scans support SUM, MIN
+    // and MAX and keep the element type.
+    enum class RED_OP : int { SUM, MIN, MAX, ARGMAX, DOT };
+
+    inline constexpr uint64_t redCtrl( RED_OP op, EW_TYPE type, bool exclusive = false ) {
+        return ( uint64_t( exclusive ) << 16 ) | ( uint64_t( static_cast<unsigned>( type ) & 0xff ) << 8 ) |
+               ( static_cast<unsigned>( op ) & 0xff );
+    }
+
+    // Pointer chase (user function U3)
+    //   params: result (SRAM), start node, next offset, max hops (0 until null),
+    //           key offset, key, chaseCtrl(match, payload bytes), payload offset
+    // Follows the 64-bit next pointer (0 terminates) from the start node for at
+    // most max hops. With match set it stops at the first node whose 64-bit key
+    // equals the key, otherwise at the last node reached.
+    // Result words: node address (0 if no match), hops taken, then the node payload.
+    const uint64_t CHASE_MATCH = 1;
+
+    inline constexpr uint64_t chaseCtrl( bool match, unsigned payloadBytes = 0 ) {
+        return ( uint64_t( payloadBytes & 0xff ) << 8 ) | ( match ? CHASE_MATCH : 0 );
+    }
+
+    // Hash probe (user function U4)
+    //   params: values (SRAM), keys (SRAM), number of keys, table, number of
+    //           buckets (power of 2), HASH_MODE, empty key (OPEN), miss value
+    //   OPEN:    buckets are {key, value} pairs probed linearly from the home
+    //            bucket. A bucket holding the empty key ends the probe.
+    //   CHAINED: buckets are 64-bit pointers to {key, value, next} nodes.
+    // The home bucket of a key is hashKey(key) & (buckets - 1).
+    enum class HASH_MODE : int { OPEN, CHAINED };
+
+    inline constexpr uint64_t hashKey( uint64_t key ) {
+        // splitmix64 finalizer
+        key ^= key >> 30;
+        key *= 0xbf58476d1ce4e5b9ull;
+        key ^= key >> 27;
+        key *= 0x94d049bb133111ebull;
+        return key ^ ( key >> 31 );
+    }
+
+    // Sort (user function U6)
+    //   params: dst, src, tmp, number of records, sortCtrl(kv, network),
+    //           SRAM tile address, tile bytes (0 runs to the end of SRAM)
+    // Records are 64-bit keys or {key, value} pairs ordered by unsigned key;
+    // equal keys keep their input order. Tiles are sorted in SRAM, then merge
+    // passes alternate between tmp and dst (both DRAM, each holding all records).
+    // Tile sort cost is modeled from sort_lanes compare-exchange units.
+    enum class SORT_NET : int { BITONIC, RADIX };
+
+    inline constexpr uint64_t sortCtrl( bool kv, SORT_NET net = SORT_NET::BITONIC ) {
+        return ( uint64_t( static_cast<unsigned>( net ) & 0xff ) << 8 ) | ( kv ? 1 : 0 );
+    }
+
+    // Filter (user function U7)
+    //   params: dst, src, result (SRAM), filterCtrl(op, type, indices),
+    //           operand a, operand b, number of elements
+    //   EQ, NE, LT, GT: x op a    RANGE: a <= x <= b    MASK: (x & a) == b
+    // Matching elements, or their 64-bit indices, are packed into dst in
+    // source order and the match count is written to result. Operands use the
+    // low bytes of the parameter, MASK compares raw bits.
+    enum class FILTER_OP : int { EQ, NE, LT, GT, RANGE, MASK };
+    const uint64_t FILTER_INDICES = 1ull << 16;
+
+    inline constexpr uint64_t filterCtrl( FILTER_OP op, EW_TYPE type, bool indices = false ) {
+        return ( indices ? FILTER_INDICES : 0 ) | ( uint64_t( static_cast<unsigned>( type ) & 0xff ) << 8 ) |
+               ( static_cast<unsigned>( op ) & 0xff );
+    }
+
+    // Histogram and group-by (user function U8)
+    //   params: dst, keys, values (SUM, FSUM), number of records, number of bins,
+    //           histCtrl(op, shift), SRAM bin address, SRAM bin bytes (0 runs
+    //           to the end of SRAM)
+    // Keys and values are 64-bit. A record lands in bin key >> shift and
+    // records past the last bin are dropped. dst receives one 64-bit aggregate
+    // per bin: a count, a wrapping sum or an fp64 sum. When the bins do not
+    // fit the SRAM window it caches lines of bins, and evicted lines spill by
+    // adding into dst, which is cleared first.
+    enum class HIST_OP : int { COUNT, SUM, FSUM };
+
+    inline constexpr uint64_t histCtrl( HIST_OP op, unsigned shift = 0 ) {
+        return ( uint64_t( shift & 0x3f ) << 8 ) | ( static_cast<unsigned>( op ) & 0xff );
+    }
+
+    // CSR sparse matrix-vector multiply y = A x (user function U9)
+    //   params: y, row_ptr, col_idx, values, x, number of rows, SRAM scratch
+    //           address, x cache bytes (taken from the end of SRAM, 0 for none)
+    // row_ptr and col_idx are 64-bit, values, x and y are fp64. Row sums
+    // accumulate in the SRAM scratch up to the x cache, a block of rows at a
+    // time, in CSR order.
+
+    // Matrix-vector and small matrix-matrix multiply Y = W B (user function U10)
+    //   params: Y, W, B (SRAM), rows, cols, gemvCtrl(type, n), W row pitch
+    //           in bytes (0 packs rows)
+    // W is rows x cols, B is cols x n and Y is rows x n, all row-major. I8
+    // inputs accumulate in wrapping int32 and Y is int32. F32 inputs
+    // accumulate in fp32. n = 1 is a GEMV.
+    inline constexpr uint64_t gemvCtrl( EW_TYPE type, unsigned n = 1 ) {
+        return ( uint64_t( n & 0xff ) << 8 ) | ( static_cast<unsigned>( type ) & 0xff );
+    }
+
+    // Delta + bit-pack codec (user functions U11 compress, U12 decompress)
+    //   compress params:   dst, src, number of 64-bit words, SRAM result address
+    //   decompress params: dst, src, compressed bytes, SRAM result address
+    // The result word receives the number of bytes written to dst. Words are
+    // coded in blocks of up to CODEC_BLOCK_WORDS: a header word (bit width in
+    // bits 7:0, word count in bits 15:8), the first word, then the zigzag
+    // coded deltas of the rest packed at that width into whole words.
+    // Constant or slowly changing data shrinks to a few bits per word, and
+    // incompressible data grows by one word per block.
+    const unsigned CODEC_BLOCK_WORDS = 64;
+
+    // Embedding bag sparse-lengths-sum (user function U13)
+    //   params: out, table, indices, lengths, number of bags,
+    //           slsCtrl(type, dim), SRAM accumulator address, table row
+    //           pitch in bytes (0 packs rows)
+    // Bag b sums the table rows named by its next lengths[b] indices into an
+    // fp32 vector of dim elements at out row b (an empty bag is all zeros).
+    // Indices and lengths are 64-bit. F32 rows hold dim floats. I8 rows hold
+    // dim int8 values followed by an fp32 scale and bias, and element q adds
+    // scale * q + bias. The accumulator takes dim * 4 bytes of SRAM.
+    inline constexpr uint64_t slsCtrl( EW_TYPE type, unsigned dim ) {
+        return ( uint64_t( dim & 0xffffff ) << 8 ) | ( static_cast<unsigned>( type ) & 0xff );
+    }
+
+    // Near-memory atomics (custom requests handled by PIM.PIMAtomicHandler)
+    // The host sends one StandardMem::CustomReq carrying a PIMAtomicData for
+    // a PIM DRAM address. The memory controller applies the op in place and
+    // responds with the old value. Operands are 1, 2, 4 or 8 bytes and
+    // naturally aligned. MIN and MAX compare signed, UMIN and UMAX unsigned.
+    // CAS stores the operand only when the old value equals the compare value.
+    enum class ATOMIC_OP : int { ADD, MIN, MAX, UMIN, UMAX, AND, OR, XOR, SWAP, CAS };
+
+    // Graph frontier expansion, one BFS or SSSP step (user function U14)
+    //   params: next frontier, frontier, frontier size, row_ptr, col_idx,
+    //           state, SRAM result address, bfsCtrl(mode, level)
+    // The graph is CSR with 64-bit row_ptr and col_idx, and frontiers are
+    // lists of 64-bit vertex ids. Every edge of a frontier vertex updates the
+    // state word of its neighbor in place, and the neighbor joins the next
+    // frontier when the update changed it:
+    //   VISIT  state is a visited bitmap and the neighbor bit is set
+    //   LEVEL  state holds a 64-bit level per vertex and a neighbor still at
+    //          BFS_UNVISITED is set to level by a compare-and-set
+    //   RELAX  col_idx holds {vertex, weight} pairs and state holds 64-bit
+    //          distances, lowered to dist[u] + weight with an unsigned min.
+    //          A vertex is emitted once per step however often it improves.
+    // The result is {next frontier size, edges visited}. The next frontier is
+    // in no particular order.
+    enum class BFS_MODE : int { VISIT, LEVEL, RELAX };
+    const uint64_t BFS_UNVISITED = ~0ull;
+
+    inline constexpr uint64_t bfsCtrl( BFS_MODE mode, uint64_t level = 0 ) {
+        return ( level << 8 ) | ( static_cast<unsigned>( mode ) & 0xff );
+    }
+
+    // Bitmap index operations (user function U15)
+    //   params: dst (0 for none), result (SRAM), bitmapCtrl(op, sources),
+    //           numBytes, source A, B, C, D
+    // Folds 2 to 4 equally sized source bitmaps a 64-bit word at a time,
+    // writes the folded bitmap to dst and the 64-bit popcount of it to
+    // result. ANDNOT keeps the bits of A that are clear in every other
+    // source. numBytes must be a multiple of 8.
+    enum class BITMAP_OP : int { AND, OR, XOR, ANDNOT };
+
+    inline constexpr uint64_t bitmapCtrl( BITMAP_OP op, unsigned sources = 2 ) {
+        return ( uint64_t( sources & 0xff ) << 8 ) | ( static_cast<unsigned>( op ) & 0xff );
+    }
+
+    // Checksums (user function U16)
+    //   params: result (SRAM), src, numBytes, csumCtrl(alg, verify), seed,
+    //           block bytes (verify), stored checksums (verify), mismatch
+    //           index address (verify, 0 for none)
+    //   CRC32C: CRC-32C (Castagnoli) in the low 32 bits. The seed is the CRC
+    //           of preceding data, so 0 gives the standard CRC-32C.
+    //   XXH64:  64-bit xxHash with the given seed.
+    // The digest of the whole range is written to result. With verify set
+    // the range is checked a block at a time against the 64-bit stored
+    // checksums, one per block (the last block may be short). Indices of
+    // mismatching blocks are packed into the mismatch address in order and
+    // their count is written to result.
+    enum class CSUM_ALG : int { CRC32C, XXH64 };
+    const uint64_t CSUM_VERIFY = 1ull << 8;
+
+    inline constexpr uint64_t csumCtrl( CSUM_ALG alg, bool verify = false ) {
+        return ( verify ? CSUM_VERIFY : 0 ) | ( static_cast<unsigned>( alg ) & 0xff );
+    }
+
+    // Stencil (user function U17)
+    //   params: dst, src, rows, cols, stencilCtrl(shape, type), coefficients
+    //           (SRAM), SRAM ring address, row pitch in bytes (0 packs rows)
+    //   POINT3: y[r][c] = k0 x[r][c] + k1 x[r][c-1] + k2 x[r][c+1]
+    //   POINT5: adds k3 x[r-1][c] + k4 x[r+1][c]
+    // The grid is row-major F32 or F64 and the coefficients k are of the same
+    // type. Cells without a full neighborhood (the first and last columns,
+    // and for POINT5 the first and last rows) are copied from src. dst is DRAM
+    // and must not overlap src. Rows stream through a ring running from the
+    // ring address to the end of SRAM, in column strips as wide as the ring
+    // allows, so each input row is read once per strip.
+    enum class STENCIL : int { POINT3, POINT5 };
+
+    inline constexpr uint64_t stencilCtrl( STENCIL shape, EW_TYPE type ) {
+        return ( uint64_t( static_cast<unsigned>( type ) & 0xff ) << 8 ) | ( static_cast<unsigned>( shape ) & 0xff );
+    }
+
+    // Bloom filter build (user function U18) and probe (user function U19)
+    //   params: filter (DRAM), filter bits (power of 2, at least 64), hash
+    //           functions, keys, number of keys, match bitmap (probe),
+    //           SRAM result address (probe, 0 for none)
+    // Keys are 64-bit. Hash function i of a key names filter bit
+    // bloomBit(key, i, bits), bit b being bit b % 64 of 64-bit word b / 64.
+    // Build sets the bits of every key in the filter, which starts cleared.
+    // Probe sets bit j of the match bitmap when every bit of key j is set in
+    // the filter, and writes the number of matches to result.
+    inline constexpr uint64_t bloomBit( uint64_t key, unsigned i, uint64_t bits ) {
+        // Double hashing with an odd stride
+        uint64_t h = hashKey( key );
+        return ( h + i * ( ( h >> 32 ) | 1 ) ) & ( bits - 1 );
+    }
+
 } //namespace SST::PIM
 
 #endif //_SST_PIMDEF_H_
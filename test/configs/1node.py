@@ -258,7 +258,7 @@ memctrl_params = {
     "debug_addr"  : debug['debug_addr'],
     "listenercount" : 0,
     "backing" : "malloc",
-    "customCmdHandler" : "memHierarchy.defCustomCmdHandler",
+    "customCmdHandler" : "PIM.PIMAtomicHandler",
 }
 
 memnic_params = {
@@ -0,0 +1,141 @@
+/*
+ * bfs.cpp
+ *
+ * Copyright (C) 2017-2024 Tactical Computing Laboratories, LLC
+ * All Rights Reserved
+ * contact@tactcomplabs.com
+ *
+ * See LICENSE in the top level directory for licensing details
+ */
+
+// Standard includes
+#include <cinttypes>
+#include <cstdlib>
+#include <cstring>
+
+// PIM definitions
+#include "revpim.h"
+
+// Globals
+const int num_vertices = 256;
+const int degree = 4;
+const int num_edges = num_vertices * degree;
+const uint64_t source = 0;
+
+// PIM Memories (non-cachable)
+uint64_t dram_row_ptr[num_vertices + 1] __attribute__((section(".pimdram")));
+uint64_t dram_col_idx[num_edges] __attribute__((section(".pimdram")));
+uint64_t dram_levels[num_vertices] __attribute__((section(".pimdram")));
+uint64_t dram_frontier[2][num_vertices] __attribute__((section(".pimdram")));
+uint64_t sram[PIM::SRAM_SIZE] __attribute__((section(".pimsram")));
+
+// Host copy of the reference levels
+uint64_t ref_levels[num_vertices];
+uint64_t ref_queue[num_vertices];
+
+// SRAM layout: {next frontier size, edges visited}
+const int res_idx = 8;
+
+uint64_t addr(const void* p) {
+  return reinterpret_cast<uint64_t>(p);
+}
+
+size_t checkPIM() {
+  size_t time1, time2;
+  // sram offset 0 initialized by PIM hardware
+  REV_TIME( time1 );
+  if (sram[0] != ( uint64_t( PIM_TYPE_TCL ) << 56 )) {
+    printf("Unexpected PIM TYPE 0x%lx\n", sram[0]);
+    assert(false);
+  }
+  REV_TIME( time2 );
+  return time2 - time1;
+}
+
+size_t configure() {
+  size_t time1, time2;
+  REV_TIME( time1 );
+  // A ring plus pseudo-random chords
+  for (int u=0; u<num_vertices; u++) {
+    dram_row_ptr[u] = u * degree;
+    dram_col_idx[u * degree] = ( u + 1 ) % num_vertices;
+    for (int i=1; i<degree; i++)
+      dram_col_idx[u * degree + i] = ( u * 97 + i * 61 + 13 ) % num_vertices;
+    dram_levels[u] = PIM::BFS_UNVISITED;
+  }
+  dram_row_ptr[num_vertices] = num_edges;
+  dram_levels[source] = 0;
+  REV_TIME( time2 );
+  return time2 - time1;
+}
+
+size_t theApp() {
+  size_t time1, time2;
+  REV_TIME( time1 );
+  // One launch per level, ping-ponging between the two frontier buffers
+  uint64_t size = 1;
+  uint64_t edges = 0;
+  int cur = 0;
+  dram_frontier[cur][0] = source;
+  for (uint64_t level=1; size; level++) {
+    revpim::init(PIM::FUNC_NUM::U14, addr(dram_frontier[1 - cur]), addr(dram_frontier[cur]), size, addr(dram_row_ptr),
+                 addr(dram_col_idx), addr(dram_levels), addr(&sram[res_idx]), PIM::bfsCtrl(PIM::BFS_MODE::LEVEL, level));
+    revpim::run(PIM::FUNC_NUM::U14);
+    revpim::finish(PIM::FUNC_NUM::U14);
+    size = sram[res_idx];
+    edges += sram[res_idx + 1];
+    cur = 1 - cur;
+  }
+  REV_TIME( time2 );
+  printf("edges visited=%" PRIu64 "\n", edges);
+  return time2 - time1;
+}
+
+size_t check() {
+  size_t time1, time2;
+  REV_TIME( time1 );
+  for (int u=0; u<num_vertices; u++)
+    ref_levels[u] = PIM::BFS_UNVISITED;
+  ref_levels[source] = 0;
+  ref_queue[0] = source;
+  int head = 0, tail = 1;
+  while (head < tail) {
+    uint64_t u = ref_queue[head++];
+    for (uint64_t e=dram_row_ptr[u]; e<dram_row_ptr[u + 1]; e++) {
+      uint64_t v = dram_col_idx[e];
+      if (ref_levels[v] == PIM::BFS_UNVISITED) {
+        ref_levels[v] = ref_levels[u] + 1;
+        ref_queue[tail++] = v;
+      }
+    }
+  }
+  for (int u=0; u<num_vertices; u++) {
+    if (dram_levels[u] != ref_levels[u]) {
+      printf("Failed: vertex %d level %" PRIu64 " expected %" PRIu64 "\n", u, dram_levels[u], ref_levels[u]);
+      assert(false);
+    }
+  }
+  REV_TIME( time2 );
+  return time2 - time1;
+}
+
+int main( int argc, char** argv ) {
+  printf("Starting bfs\n");
+  size_t time_id, time_config, time_exec, time_check;
+
+  printf("\nsram=0x%lx\ndram_row_ptr=0x%lx\ndram_col_idx=0x%lx\ndram_levels=0x%lx\nnum_vertices=%d\n", addr(sram), addr(dram_row_ptr), addr(dram_col_idx), addr(dram_levels), num_vertices);
+
+  printf("Checking PIM ID...\n");
+  time_id = checkPIM();
+  printf("Configuring...\n");
+  time_config = configure();
+  printf("Executing...\n");
+  time_exec = theApp();
+  printf("Checking...\n");
+  time_check = check();
+
+  printf("Results:\n");
+  printf("cycles: id_check=%d, config=%d, exec=%d, check=%d\n", time_id, time_config, time_exec, time_check);
+  printf("bfs completed normally\n");
+  return 0;
+}
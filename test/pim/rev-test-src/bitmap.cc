@@ -0,0 +1,126 @@
+/*
+ * bitmap.cpp
+ *
+ * Copyright (C) 2017-2024 Tactical Computing Laboratories, LLC
+ * All Rights Reserved
+ * contact@tactcomplabs.com
+ *
+ * See LICENSE in the top level directory for licensing details
+ */
+
+// Standard includes
+#include <cinttypes>
+#include <cstdlib>
+#include <cstring>
+
+// PIM definitions
+#include "revpim.h"
+
+// Globals
+const int num_words = 512;
+
+// PIM Memories (non-cachable)
+uint64_t dram_a[num_words] __attribute__((section(".pimdram")));
+uint64_t dram_b[num_words] __attribute__((section(".pimdram")));
+uint64_t dram_c[num_words] __attribute__((section(".pimdram")));
+uint64_t dram_dst[num_words] __attribute__((section(".pimdram")));
+uint64_t sram[PIM::SRAM_SIZE] __attribute__((section(".pimsram")));
+
+// SRAM layout: popcounts
+const int res_idx = 8;
+
+uint64_t addr(const void* p) {
+  return reinterpret_cast<uint64_t>(p);
+}
+
+uint64_t popcount(uint64_t x) {
+  uint64_t n = 0;
+  for (; x; x &= x - 1)
+    n++;
+  return n;
+}
+
+size_t checkPIM() {
+  size_t time1, time2;
+  // sram offset 0 initialized by PIM hardware
+  REV_TIME( time1 );
+  if (sram[0] != ( uint64_t( PIM_TYPE_TCL ) << 56 )) {
+    printf("Unexpected PIM TYPE 0x%lx\n", sram[0]);
+    assert(false);
+  }
+  REV_TIME( time2 );
+  return time2 - time1;
+}
+
+size_t configure() {
+  size_t time1, time2;
+  REV_TIME( time1 );
+  uint64_t x = 0x9e3779b97f4a7c15;
+  for (int i=0; i<num_words; i++) {
+    x ^= x << 13; x ^= x >> 7; x ^= x << 17;
+    dram_a[i] = x;
+    dram_b[i] = x * 0x2545f4914f6cdd1d;
+    dram_c[i] = ( x >> 3 ) | ( uint64_t( i ) << 40 );
+  }
+  REV_TIME( time2 );
+  return time2 - time1;
+}
+
+size_t theApp() {
+  size_t time1, time2;
+  REV_TIME( time1 );
+  // (A & B & C) into dst, then the popcount of A ^ B alone
+  revpim::init(PIM::FUNC_NUM::U15, addr(dram_dst), addr(&sram[res_idx]), PIM::bitmapCtrl(PIM::BITMAP_OP::AND, 3),
+               num_words * sizeof(uint64_t), addr(dram_a), addr(dram_b), addr(dram_c), 0);
+  revpim::run(PIM::FUNC_NUM::U15);
+  revpim::finish(PIM::FUNC_NUM::U15);
+  revpim::init(PIM::FUNC_NUM::U15, 0, addr(&sram[res_idx + 1]), PIM::bitmapCtrl(PIM::BITMAP_OP::XOR, 2),
+               num_words * sizeof(uint64_t), addr(dram_a), addr(dram_b), 0, 0);
+  revpim::run(PIM::FUNC_NUM::U15);
+  revpim::finish(PIM::FUNC_NUM::U15);
+  REV_TIME( time2 );
+  return time2 - time1;
+}
+
+size_t check() {
+  size_t time1, time2;
+  REV_TIME( time1 );
+  uint64_t and_count = 0, xor_count = 0;
+  for (int i=0; i<num_words; i++) {
+    uint64_t w = dram_a[i] & dram_b[i] & dram_c[i];
+    if (dram_dst[i] != w) {
+      printf("Failed: word %d 0x%" PRIx64 " expected 0x%" PRIx64 "\n", i, dram_dst[i], w);
+      assert(false);
+    }
+    and_count += popcount(w);
+    xor_count += popcount(dram_a[i] ^ dram_b[i]);
+  }
+  if (sram[res_idx] != and_count || sram[res_idx + 1] != xor_count) {
+    printf("Failed: popcounts %" PRIu64 " %" PRIu64 " expected %" PRIu64 " %" PRIu64 "\n",
+           sram[res_idx], sram[res_idx + 1], and_count, xor_count);
+    assert(false);
+  }
+  REV_TIME( time2 );
+  return time2 - time1;
+}
+
+int main( int argc, char** argv ) {
+  printf("Starting bitmap\n");
+  size_t time_id, time_config, time_exec, time_check;
+
+  printf("\nsram=0x%lx\ndram_a=0x%lx\ndram_b=0x%lx\ndram_c=0x%lx\ndram_dst=0x%lx\nnum_words=%d\n", addr(sram), addr(dram_a), addr(dram_b), addr(dram_c), addr(dram_dst), num_words);
+
+  printf("Checking PIM ID...\n");
+  time_id = checkPIM();
+  printf("Configuring...\n");
+  time_config = configure();
+  printf("Executing...\n");
+  time_exec = theApp();
+  printf("Checking...\n");
+  time_check = check();
+
+  printf("Results:\n");
+  printf("cycles: id_check=%d, config=%d, exec=%d, check=%d\n", time_id, time_config, time_exec, time_check);
+  printf("bitmap completed normally\n");
+  return 0;
+}
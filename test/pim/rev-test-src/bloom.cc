@@ -0,0 +1,133 @@
+/*
+ * bloom.cpp
+ *
+ * Copyright (C) 2017-2024 Tactical Computing Laboratories, LLC
+ * All Rights Reserved
+ * contact@tactcomplabs.com
+ *
+ * See LICENSE in the top level directory for licensing details
+ */
+
+// Standard includes
+#include <cinttypes>
+#include <cstdlib>
+#include <cstring>
+
+// PIM definitions
+#include "revpim.h"
+
+// Globals
+const int bits = 8192;
+const int hashes = 3;
+const int nkeys = 256;
+const int nprobes = 512;
+
+// PIM Memories (non-cachable)
+uint64_t dram_filter[bits / 64] __attribute__((section(".pimdram")));
+uint64_t dram_keys[nkeys] __attribute__((section(".pimdram")));
+uint64_t dram_probes[nprobes] __attribute__((section(".pimdram")));
+uint64_t sram[PIM::SRAM_SIZE] __attribute__((section(".pimsram")));
+
+// SRAM layout: match count, then the match bitmap
+const int result_idx = 8;
+const int match_idx = 16;
+
+uint64_t addr(const void* p) {
+  return reinterpret_cast<uint64_t>(p);
+}
+
+size_t checkPIM() {
+  size_t time1, time2;
+  // sram offset 0 initialized by PIM hardware
+  REV_TIME( time1 );
+  if (sram[0] != ( uint64_t( PIM_TYPE_TCL ) << 56 )) {
+    printf("Unexpected PIM TYPE 0x%lx\n", sram[0]);
+    assert(false);
+  }
+  REV_TIME( time2 );
+  return time2 - time1;
+}
+
+size_t configure() {
+  size_t time1, time2;
+  REV_TIME( time1 );
+  memset(dram_filter, 0, sizeof(dram_filter));
+  for (int i=0; i<nkeys; i++)
+    dram_keys[i] = uint64_t(i) * 0x9e3779b97f4a7c15ull;
+  // Every other probe is a build key
+  for (int i=0; i<nprobes; i++)
+    dram_probes[i] = (i % 2) ? dram_keys[i / 2] : uint64_t(i) * 0xc2b2ae3d27d4eb4full + 1;
+  REV_TIME( time2 );
+  return time2 - time1;
+}
+
+size_t theApp() {
+  size_t time1, time2;
+  REV_TIME( time1 );
+  revpim::init(PIM::FUNC_NUM::U18, addr(dram_filter), bits, hashes, addr(dram_keys), nkeys, 0, 0, 0);
+  revpim::run(PIM::FUNC_NUM::U18);
+  revpim::finish(PIM::FUNC_NUM::U18);
+  revpim::init(PIM::FUNC_NUM::U19, addr(dram_filter), bits, hashes, addr(dram_probes), nprobes,
+               addr(&sram[match_idx]), addr(&sram[result_idx]), 0);
+  revpim::run(PIM::FUNC_NUM::U19);
+  revpim::finish(PIM::FUNC_NUM::U19);
+  REV_TIME( time2 );
+  return time2 - time1;
+}
+
+bool test(uint64_t key) {
+  bool hit = true;
+  for (int i=0; i<hashes; i++) {
+    uint64_t b = PIM::bloomBit(key, i, bits);
+    hit = hit && ((dram_filter[b / 64] >> (b % 64)) & 1);
+  }
+  return hit;
+}
+
+size_t check() {
+  size_t time1, time2;
+  REV_TIME( time1 );
+  for (int i=0; i<nkeys; i++) {
+    if (!test(dram_keys[i])) {
+      printf("Failed: key %d not in filter\n", i);
+      assert(false);
+    }
+  }
+  uint64_t matches = 0;
+  for (int i=0; i<nprobes; i++) {
+    bool e = test(dram_probes[i]);
+    bool got = (sram[match_idx + i / 64] >> (i % 64)) & 1;
+    matches += e;
+    if (got != e) {
+      printf("Failed: probe %d got %d expected %d\n", i, got, e);
+      assert(false);
+    }
+  }
+  if (sram[result_idx] != matches) {
+    printf("Failed: %" PRIu64 " matches expected %" PRIu64 "\n", sram[result_idx], matches);
+    assert(false);
+  }
+  REV_TIME( time2 );
+  return time2 - time1;
+}
+
+int main( int argc, char** argv ) {
+  printf("Starting bloom\n");
+  size_t time_id, time_config, time_exec, time_check;
+
+  printf("\nsram=0x%lx\ndram_filter=0x%lx\ndram_keys=0x%lx\ndram_probes=0x%lx\n", addr(sram), addr(dram_filter), addr(dram_keys), addr(dram_probes));
+
+  printf("Checking PIM ID...\n");
+  time_id = checkPIM();
+  printf("Configuring...\n");
+  time_config = configure();
+  printf("Executing...\n");
+  time_exec = theApp();
+  printf("Checking...\n");
+  time_check = check();
+
+  printf("Results:\n");
+  printf("cycles: id_check=%d, config=%d, exec=%d, check=%d\n", time_id, time_config, time_exec, time_check);
+  printf("bloom completed normally\n");
+  return 0;
+}
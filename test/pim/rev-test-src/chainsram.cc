@@ -0,0 +1,112 @@
+/*
+ * chainsram.cpp
+ *
+ * Copyright (C) 2017-2024 Tactical Computing Laboratories, LLC
+ * All Rights Reserved
+ * contact@tactcomplabs.com
+ *
+ * See LICENSE in the top level directory for licensing details
+ */
+
+// Standard includes
+#include <cinttypes>
+#include <cstdlib>
+#include <cstring>
+
+// PIM definitions
+#include "revpim.h"
+
+// Globals
+const int xfr_size = 32;      // dwords staged through SRAM
+const uint64_t scalar = 5;
+uint64_t check_data[xfr_size];
+
+// PIM Memories (non-cachable)
+uint64_t dram_dst[xfr_size] __attribute__((section(".pimdram")));
+uint64_t dram_tmp[xfr_size] __attribute__((section(".pimdram")));
+uint64_t dram_src[xfr_size] __attribute__((section(".pimdram")));
+uint64_t sram[PIM::SRAM_SIZE] __attribute__((section(".pimsram")));
+
+// SRAM layout: staging tile, descriptor ring, completion slot
+const int tile_idx = 8;
+const int ring_idx = tile_idx + xfr_size;
+const int ring_words = 16;
+const int cpl_idx = ring_idx + ring_words;
+
+size_t checkPIM() {
+  size_t time1, time2;
+  // sram offset 0 initialized by PIM hardware
+  REV_TIME( time1 );
+  if (sram[0] != ( uint64_t( PIM_TYPE_TCL ) << 56 )) {
+    printf("Unexpected PIM TYPE 0x%lx\n", sram[0]);
+    assert(false);
+  }
+  REV_TIME( time2 );
+  return time2 - time1;
+}
+
+size_t configure() {
+  size_t time1, time2;
+  REV_TIME( time1 );
+  for (int i=0; i<xfr_size ;i++) {
+    uint64_t d = (0xbeef << 16) | i;
+    check_data[i] = scalar * d;
+    dram_src[i] = d;
+  }
+  revpim::ring_init(&sram[ring_idx], ring_words);
+  REV_TIME( time2 );
+  return time2 - time1;
+}
+
+size_t theApp() {
+  size_t time1, time2;
+  size_t bytes = xfr_size*sizeof(uint64_t);
+  REV_TIME( time1 );
+  // DRAM -> SRAM -> DRAM -> scaled DRAM, sequenced on the PIM with one doorbell
+  revpim::ring_push(PIM::FUNC_NUM::F1, nullptr, &sram[tile_idx], dram_src, bytes);
+  revpim::ring_depends(1);
+  revpim::ring_push(PIM::FUNC_NUM::F1, nullptr, dram_tmp, &sram[tile_idx], bytes);
+  revpim::ring_depends(1);
+  revpim::ring_push(PIM::FUNC_NUM::U5, &sram[cpl_idx], dram_dst, dram_tmp, scalar, bytes);
+  revpim::ring_doorbell();
+  revpim::ring_wait(&sram[cpl_idx]);
+  REV_TIME( time2 );
+  return time2 - time1;
+}
+
+size_t check() {
+  size_t time1, time2;
+  REV_TIME( time1 );
+  for (int i=0; i<xfr_size; i++) {
+    if (check_data[i] != dram_dst[i]) {
+      printf("Failed: check_data[%d]=0x%lx dram_dst[%d]=0x%lx\n",
+              i, check_data[i], i, dram_dst[i]);
+      assert(false);
+    }
+  }
+  REV_TIME( time2 );
+  return time2 - time1;
+}
+
+int main( int argc, char** argv ) {
+  printf("Starting chainsram\n");
+  size_t time_id, time_config, time_exec, time_check;
+
+  printf("\nsram=0x%lx\ndram_dst=0x%lx\ndram_src=0x%lx\nxfr_size=%d\n",
+    reinterpret_cast<uint64_t>(sram), reinterpret_cast<uint64_t>(dram_dst), reinterpret_cast<uint64_t>(dram_src), xfr_size
+  );
+
+  printf("Checking PIM ID...\n");
+  time_id = checkPIM();
+  printf("Configuring...\n");
+  time_config = configure();
+  printf("Executing...\n");
+  time_exec = theApp();
+  printf("Checking...\n");
+  time_check = check();
+
+  printf("Results:\n");
+  printf("cycles: id_check=%d, config=%d, exec=%d, check=%d\n", time_id, time_config, time_exec, time_check);
+  printf("chainsram completed normally\n");
+  return 0;
+}
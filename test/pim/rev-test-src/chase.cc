@@ -0,0 +1,114 @@
+/*
+ * chase.cpp
+ *
+ * Copyright (C) 2017-2024 Tactical Computing Laboratories, LLC
+ * All Rights Reserved
+ * contact@tactcomplabs.com
+ *
+ * See LICENSE in the top level directory for licensing details
+ */
+
+// Standard includes
+#include <cinttypes>
+#include <cstdlib>
+#include <cstddef>
+#include <cstring>
+
+// PIM definitions
+#include "revpim.h"
+
+// Globals
+struct node_t {
+  uint64_t key;
+  uint64_t payload;
+  node_t*  next;
+  uint64_t pad;
+};
+const int num_nodes = 128;
+const int target = 97;
+const uint64_t target_key = 0x5000 + target;
+
+// PIM Memories (non-cachable)
+node_t dram_nodes[num_nodes] __attribute__((section(".pimdram")));
+uint64_t sram[PIM::SRAM_SIZE] __attribute__((section(".pimsram")));
+
+// SRAM result: node address, hops, payload
+const int result_idx = 8;
+
+uint64_t addr(const void* p) {
+  return reinterpret_cast<uint64_t>(p);
+}
+
+size_t checkPIM() {
+  size_t time1, time2;
+  // sram offset 0 initialized by PIM hardware
+  REV_TIME( time1 );
+  if (sram[0] != ( uint64_t( PIM_TYPE_TCL ) << 56 )) {
+    printf("Unexpected PIM TYPE 0x%lx\n", sram[0]);
+    assert(false);
+  }
+  REV_TIME( time2 );
+  return time2 - time1;
+}
+
+size_t configure() {
+  size_t time1, time2;
+  REV_TIME( time1 );
+  // List order strides through the array so consecutive hops are far apart
+  for (int k=0; k<num_nodes ;k++) {
+    node_t* n = &dram_nodes[(k * 37) % num_nodes];
+    n->key = 0x5000 + k;
+    n->payload = 0xcafe0000 | k;
+    n->next = k + 1 < num_nodes ? &dram_nodes[((k + 1) * 37) % num_nodes] : nullptr;
+  }
+  REV_TIME( time2 );
+  return time2 - time1;
+}
+
+size_t theApp() {
+  size_t time1, time2;
+  REV_TIME( time1 );
+  revpim::init(PIM::FUNC_NUM::U3, addr(&sram[result_idx]), addr(&dram_nodes[0]), offsetof(node_t, next), 0,
+               offsetof(node_t, key), target_key, PIM::chaseCtrl(true, sizeof(uint64_t)), offsetof(node_t, payload));
+  revpim::run(PIM::FUNC_NUM::U3);
+  revpim::finish(PIM::FUNC_NUM::U3);
+  REV_TIME( time2 );
+  return time2 - time1;
+}
+
+size_t check() {
+  size_t time1, time2;
+  REV_TIME( time1 );
+  node_t* expect = &dram_nodes[(target * 37) % num_nodes];
+  if (sram[result_idx] != addr(expect) || sram[result_idx + 1] != target) {
+    printf("Failed: node=0x%lx hops=%ld expected 0x%lx %d\n", sram[result_idx], sram[result_idx + 1], addr(expect), target);
+    assert(false);
+  }
+  if (sram[result_idx + 2] != expect->payload) {
+    printf("Failed: payload=0x%lx expected 0x%lx\n", sram[result_idx + 2], expect->payload);
+    assert(false);
+  }
+  REV_TIME( time2 );
+  return time2 - time1;
+}
+
+int main( int argc, char** argv ) {
+  printf("Starting chase\n");
+  size_t time_id, time_config, time_exec, time_check;
+
+  printf("\nsram=0x%lx\ndram_nodes=0x%lx\nnum_nodes=%d\n", addr(sram), addr(dram_nodes), num_nodes);
+
+  printf("Checking PIM ID...\n");
+  time_id = checkPIM();
+  printf("Configuring...\n");
+  time_config = configure();
+  printf("Executing...\n");
+  time_exec = theApp();
+  printf("Checking...\n");
+  time_check = check();
+
+  printf("Results:\n");
+  printf("cycles: id_check=%d, config=%d, exec=%d, check=%d\n", time_id, time_config, time_exec, time_check);
+  printf("chase completed normally\n");
+  return 0;
+}
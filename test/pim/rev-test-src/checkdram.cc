@@ -86,7 +86,7 @@ size_t theApp() {
   REV_TIME( time1 );
   revpim::init(PIM::FUNC_NUM::F1, dram_dst, dram_src, xfr_size*sizeof(uint64_t));
   revpim::run(PIM::FUNC_NUM::F1);
-  revpim::finish(PIM::FUNC_NUM::F1); // blocking polling loop :(
+  revpim::finish(PIM::FUNC_NUM::F1); // single blocking status read
   REV_TIME( time2 );
   return time2 - time1;
 }
@@ -0,0 +1,135 @@
+/*
+ * checksum.cpp
+ *
+ * Copyright (C) 2017-2024 Tactical Computing Laboratories, LLC
+ * All Rights Reserved
+ * contact@tactcomplabs.com
+ *
+ * See LICENSE in the top level directory for licensing details
+ */
+
+// Standard includes
+#include <cinttypes>
+#include <cstdlib>
+#include <cstring>
+
+// PIM definitions
+#include "revpim.h"
+
+// Globals
+const int num_bytes = 4096;
+const int block_bytes = 1024;
+const int num_blocks = num_bytes / block_bytes;
+const int bad_block = 2;
+const uint64_t seed = 42;
+
+// PIM Memories (non-cachable)
+uint8_t dram_buf[num_bytes] __attribute__((section(".pimdram")));
+uint64_t dram_sums[num_blocks] __attribute__((section(".pimdram")));
+uint64_t dram_bad[num_blocks] __attribute__((section(".pimdram")));
+uint64_t sram[PIM::SRAM_SIZE] __attribute__((section(".pimsram")));
+
+// SRAM layout: CRC, verify result, block digest
+const int crc_idx = 8;
+const int verify_idx = 9;
+const int digest_idx = 10;
+
+uint64_t addr(const void* p) {
+  return reinterpret_cast<uint64_t>(p);
+}
+
+// Bitwise CRC-32C reference
+uint32_t crc32c(const uint8_t* p, size_t n) {
+  uint32_t crc = ~0u;
+  for (size_t i=0; i<n; i++) {
+    crc ^= p[i];
+    for (int k=0; k<8; k++)
+      crc = ( crc >> 1 ) ^ ( 0x82f63b78u & ( 0 - ( crc & 1 ) ) );
+  }
+  return ~crc;
+}
+
+size_t checkPIM() {
+  size_t time1, time2;
+  // sram offset 0 initialized by PIM hardware
+  REV_TIME( time1 );
+  if (sram[0] != ( uint64_t( PIM_TYPE_TCL ) << 56 )) {
+    printf("Unexpected PIM TYPE 0x%lx\n", sram[0]);
+    assert(false);
+  }
+  REV_TIME( time2 );
+  return time2 - time1;
+}
+
+size_t configure() {
+  size_t time1, time2;
+  REV_TIME( time1 );
+  for (int i=0; i<num_bytes; i++)
+    dram_buf[i] = uint8_t( i * 131 + ( i >> 5 ) );
+  REV_TIME( time2 );
+  return time2 - time1;
+}
+
+size_t theApp() {
+  size_t time1, time2;
+  REV_TIME( time1 );
+  // CRC-32C of the whole buffer
+  revpim::init(PIM::FUNC_NUM::U16, addr(&sram[crc_idx]), addr(dram_buf), num_bytes, PIM::csumCtrl(PIM::CSUM_ALG::CRC32C),
+               0, 0, 0, 0);
+  revpim::run(PIM::FUNC_NUM::U16);
+  revpim::finish(PIM::FUNC_NUM::U16);
+  // Store an xxHash64 per block, damage one block, then verify
+  for (int b=0; b<num_blocks; b++) {
+    revpim::init(PIM::FUNC_NUM::U16, addr(&sram[digest_idx]), addr(&dram_buf[b * block_bytes]), block_bytes,
+                 PIM::csumCtrl(PIM::CSUM_ALG::XXH64), seed, 0, 0, 0);
+    revpim::run(PIM::FUNC_NUM::U16);
+    revpim::finish(PIM::FUNC_NUM::U16);
+    dram_sums[b] = sram[digest_idx];
+  }
+  dram_buf[bad_block * block_bytes + 17] ^= 0x10;
+  revpim::init(PIM::FUNC_NUM::U16, addr(&sram[verify_idx]), addr(dram_buf), num_bytes,
+               PIM::csumCtrl(PIM::CSUM_ALG::XXH64, true), seed, block_bytes, addr(dram_sums), addr(dram_bad));
+  revpim::run(PIM::FUNC_NUM::U16);
+  revpim::finish(PIM::FUNC_NUM::U16);
+  REV_TIME( time2 );
+  return time2 - time1;
+}
+
+size_t check() {
+  size_t time1, time2;
+  REV_TIME( time1 );
+  // The CRC was taken before the buffer was damaged
+  dram_buf[bad_block * block_bytes + 17] ^= 0x10;
+  uint32_t crc = crc32c(dram_buf, num_bytes);
+  if (sram[crc_idx] != crc) {
+    printf("Failed: crc 0x%" PRIx64 " expected 0x%x\n", sram[crc_idx], crc);
+    assert(false);
+  }
+  if (sram[verify_idx] != 1 || dram_bad[0] != bad_block) {
+    printf("Failed: %" PRIu64 " mismatches, first %" PRIu64 "\n", sram[verify_idx], dram_bad[0]);
+    assert(false);
+  }
+  REV_TIME( time2 );
+  return time2 - time1;
+}
+
+int main( int argc, char** argv ) {
+  printf("Starting checksum\n");
+  size_t time_id, time_config, time_exec, time_check;
+
+  printf("\nsram=0x%lx\ndram_buf=0x%lx\ndram_sums=0x%lx\nnum_bytes=%d\n", addr(sram), addr(dram_buf), addr(dram_sums), num_bytes);
+
+  printf("Checking PIM ID...\n");
+  time_id = checkPIM();
+  printf("Configuring...\n");
+  time_config = configure();
+  printf("Executing...\n");
+  time_exec = theApp();
+  printf("Checking...\n");
+  time_check = check();
+
+  printf("Results:\n");
+  printf("cycles: id_check=%d, config=%d, exec=%d, check=%d\n", time_id, time_config, time_exec, time_check);
+  printf("checksum completed normally\n");
+  return 0;
+}
@@ -0,0 +1,115 @@
+/*
+ * codec.cpp
+ *
+ * Copyright (C) 2017-2024 Tactical Computing Laboratories, LLC
+ * All Rights Reserved
+ * contact@tactcomplabs.com
+ *
+ * See LICENSE in the top level directory for licensing details
+ */
+
+// Standard includes
+#include <cinttypes>
+#include <cstdlib>
+#include <cstring>
+
+// PIM definitions
+#include "revpim.h"
+
+// Globals
+const int num_words = 1000;
+// Worst case: one extra word per block
+const int max_compressed_words = num_words + ( num_words + PIM::CODEC_BLOCK_WORDS - 1 ) / PIM::CODEC_BLOCK_WORDS;
+
+// PIM Memories (non-cachable)
+uint64_t dram_src[num_words] __attribute__((section(".pimdram")));
+uint64_t dram_compressed[max_compressed_words] __attribute__((section(".pimdram")));
+uint64_t dram_dst[num_words] __attribute__((section(".pimdram")));
+uint64_t sram[PIM::SRAM_SIZE] __attribute__((section(".pimsram")));
+
+// SRAM layout: compressed bytes, decompressed bytes
+const int compressed_idx = 8;
+const int decompressed_idx = 9;
+
+uint64_t addr(const void* p) {
+  return reinterpret_cast<uint64_t>(p);
+}
+
+size_t checkPIM() {
+  size_t time1, time2;
+  // sram offset 0 initialized by PIM hardware
+  REV_TIME( time1 );
+  if (sram[0] != ( uint64_t( PIM_TYPE_TCL ) << 56 )) {
+    printf("Unexpected PIM TYPE 0x%lx\n", sram[0]);
+    assert(false);
+  }
+  REV_TIME( time2 );
+  return time2 - time1;
+}
+
+size_t configure() {
+  size_t time1, time2;
+  REV_TIME( time1 );
+  // Slowly increasing timestamps with small jitter
+  for (int i=0; i<num_words; i++)
+    dram_src[i] = 1700000000000ull + uint64_t(i) * 10 + ( ( i * 7919 ) % 5 );
+  REV_TIME( time2 );
+  return time2 - time1;
+}
+
+size_t theApp() {
+  size_t time1, time2;
+  REV_TIME( time1 );
+  revpim::init(PIM::FUNC_NUM::U11, addr(dram_compressed), addr(dram_src), num_words, addr(&sram[compressed_idx]));
+  revpim::run(PIM::FUNC_NUM::U11);
+  revpim::finish(PIM::FUNC_NUM::U11);
+  revpim::init(PIM::FUNC_NUM::U12, addr(dram_dst), addr(dram_compressed), sram[compressed_idx], addr(&sram[decompressed_idx]));
+  revpim::run(PIM::FUNC_NUM::U12);
+  revpim::finish(PIM::FUNC_NUM::U12);
+  REV_TIME( time2 );
+  return time2 - time1;
+}
+
+size_t check() {
+  size_t time1, time2;
+  REV_TIME( time1 );
+  uint64_t compressed = sram[compressed_idx];
+  printf("compressed %d bytes to %ld\n", num_words * 8, compressed);
+  if (compressed == 0 || compressed >= uint64_t(num_words * 8) / 4) {
+    printf("Failed: compressed size %ld\n", compressed);
+    assert(false);
+  }
+  if (sram[decompressed_idx] != uint64_t(num_words * 8)) {
+    printf("Failed: decompressed size %ld\n", sram[decompressed_idx]);
+    assert(false);
+  }
+  for (int i=0; i<num_words; i++) {
+    if (dram_dst[i] != dram_src[i]) {
+      printf("Failed: word %d=%ld expected %ld\n", i, dram_dst[i], dram_src[i]);
+      assert(false);
+    }
+  }
+  REV_TIME( time2 );
+  return time2 - time1;
+}
+
+int main( int argc, char** argv ) {
+  printf("Starting codec\n");
+  size_t time_id, time_config, time_exec, time_check;
+
+  printf("\nsram=0x%lx\ndram_src=0x%lx\ndram_compressed=0x%lx\ndram_dst=0x%lx\nnum_words=%d\n", addr(sram), addr(dram_src), addr(dram_compressed), addr(dram_dst), num_words);
+
+  printf("Checking PIM ID...\n");
+  time_id = checkPIM();
+  printf("Configuring...\n");
+  time_config = configure();
+  printf("Executing...\n");
+  time_exec = theApp();
+  printf("Checking...\n");
+  time_check = check();
+
+  printf("Results:\n");
+  printf("cycles: id_check=%d, config=%d, exec=%d, check=%d\n", time_id, time_config, time_exec, time_check);
+  printf("codec completed normally\n");
+  return 0;
+}
@@ -0,0 +1,125 @@
+/*
+ * elementwise.cpp
+ *
+ * Copyright (C) 2017-2024 Tactical Computing Laboratories, LLC
+ * All Rights Reserved
+ * contact@tactcomplabs.com
+ *
+ * See LICENSE in the top level directory for licensing details
+ */
+
+// Standard includes
+#include <cinttypes>
+#include <cstdlib>
+#include <cstring>
+
+// PIM definitions
+#include "revpim.h"
+
+// Globals
+const int num_elems = 256;
+const double alpha = 2.5;
+double  check_axpy[num_elems];
+int32_t check_max[num_elems];
+
+// PIM Memories (non-cachable)
+double  dram_x[num_elems] __attribute__((section(".pimdram")));
+double  dram_y[num_elems] __attribute__((section(".pimdram")));
+double  dram_z[num_elems] __attribute__((section(".pimdram")));
+int32_t dram_a[num_elems] __attribute__((section(".pimdram")));
+int32_t dram_b[num_elems] __attribute__((section(".pimdram")));
+int32_t dram_m[num_elems] __attribute__((section(".pimdram")));
+int32_t dram_c[num_elems] __attribute__((section(".pimdram")));
+uint64_t sram[PIM::SRAM_SIZE] __attribute__((section(".pimsram")));
+
+uint64_t addr(const void* p) {
+  return reinterpret_cast<uint64_t>(p);
+}
+
+size_t checkPIM() {
+  size_t time1, time2;
+  // sram offset 0 initialized by PIM hardware
+  REV_TIME( time1 );
+  if (sram[0] != ( uint64_t( PIM_TYPE_TCL ) << 56 )) {
+    printf("Unexpected PIM TYPE 0x%lx\n", sram[0]);
+    assert(false);
+  }
+  REV_TIME( time2 );
+  return time2 - time1;
+}
+
+size_t configure() {
+  size_t time1, time2;
+  REV_TIME( time1 );
+  for (int i=0; i<num_elems ;i++) {
+    dram_x[i] = 0.5 * i;
+    dram_y[i] = 100.0 - i;
+    check_axpy[i] = alpha * dram_x[i] + dram_y[i];
+    dram_a[i] = (i * 37) % 101 - 50;
+    dram_b[i] = (i * 13) % 61 - 30;
+    check_max[i] = dram_a[i] < dram_b[i] ? dram_b[i] : dram_a[i];
+  }
+  REV_TIME( time2 );
+  return time2 - time1;
+}
+
+size_t theApp() {
+  size_t time1, time2;
+  uint64_t alpha_bits;
+  memcpy(&alpha_bits, &alpha, sizeof(alpha_bits));
+  REV_TIME( time1 );
+  // fp64 z = alpha * x + y
+  revpim::init(PIM::FUNC_NUM::U0, addr(dram_z), addr(dram_x), addr(dram_y), 0,
+               PIM::ewCtrl(PIM::EW_OP::AXPY, PIM::EW_TYPE::F64), alpha_bits, sizeof(dram_z));
+  revpim::run(PIM::FUNC_NUM::U0);
+  revpim::finish(PIM::FUNC_NUM::U0);
+  // int32 m = a < b, c = m ? b : a
+  revpim::init(PIM::FUNC_NUM::U0, addr(dram_m), addr(dram_a), addr(dram_b), 0,
+               PIM::ewCtrl(PIM::EW_OP::CMPLT, PIM::EW_TYPE::I32), 0, sizeof(dram_m));
+  revpim::run(PIM::FUNC_NUM::U0);
+  revpim::finish(PIM::FUNC_NUM::U0);
+  revpim::init(PIM::FUNC_NUM::U0, addr(dram_c), addr(dram_b), addr(dram_a), addr(dram_m),
+               PIM::ewCtrl(PIM::EW_OP::SELECT, PIM::EW_TYPE::I32), 0, sizeof(dram_c));
+  revpim::run(PIM::FUNC_NUM::U0);
+  revpim::finish(PIM::FUNC_NUM::U0);
+  REV_TIME( time2 );
+  return time2 - time1;
+}
+
+size_t check() {
+  size_t time1, time2;
+  REV_TIME( time1 );
+  for (int i=0; i<num_elems; i++) {
+    if (check_axpy[i] != dram_z[i]) {
+      printf("Failed: axpy[%d]\n", i);
+      assert(false);
+    }
+    if (check_max[i] != dram_c[i]) {
+      printf("Failed: check_max[%d]=%d dram_c[%d]=%d\n", i, check_max[i], i, dram_c[i]);
+      assert(false);
+    }
+  }
+  REV_TIME( time2 );
+  return time2 - time1;
+}
+
+int main( int argc, char** argv ) {
+  printf("Starting elementwise\n");
+  size_t time_id, time_config, time_exec, time_check;
+
+  printf("\ndram_x=0x%lx\ndram_a=0x%lx\nnum_elems=%d\n", addr(dram_x), addr(dram_a), num_elems);
+
+  printf("Checking PIM ID...\n");
+  time_id = checkPIM();
+  printf("Configuring...\n");
+  time_config = configure();
+  printf("Executing...\n");
+  time_exec = theApp();
+  printf("Checking...\n");
+  time_check = check();
+
+  printf("Results:\n");
+  printf("cycles: id_check=%d, config=%d, exec=%d, check=%d\n", time_id, time_config, time_exec, time_check);
+  printf("elementwise completed normally\n");
+  return 0;
+}
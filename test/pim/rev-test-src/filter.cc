@@ -0,0 +1,115 @@
+/*
+ * filter.cpp
+ *
+ * Copyright (C) 2017-2024 Tactical Computing Laboratories, LLC
+ * All Rights Reserved
+ * contact@tactcomplabs.com
+ *
+ * See LICENSE in the top level directory for licensing details
+ */
+
+// Standard includes
+#include <cinttypes>
+#include <cstdlib>
+#include <cstring>
+
+// PIM definitions
+#include "revpim.h"
+
+// Globals
+const int num_elements = 1000;
+const int32_t lo = -20;
+const int32_t hi = 20;
+int check_count;
+
+// PIM Memories (non-cachable)
+int32_t  dram_column[num_elements] __attribute__((section(".pimdram")));
+uint64_t dram_indices[num_elements] __attribute__((section(".pimdram")));
+uint64_t sram[PIM::SRAM_SIZE] __attribute__((section(".pimsram")));
+
+// SRAM layout: match count
+const int count_idx = 8;
+
+uint64_t addr(const void* p) {
+  return reinterpret_cast<uint64_t>(p);
+}
+
+size_t checkPIM() {
+  size_t time1, time2;
+  // sram offset 0 initialized by PIM hardware
+  REV_TIME( time1 );
+  if (sram[0] != ( uint64_t( PIM_TYPE_TCL ) << 56 )) {
+    printf("Unexpected PIM TYPE 0x%lx\n", sram[0]);
+    assert(false);
+  }
+  REV_TIME( time2 );
+  return time2 - time1;
+}
+
+size_t configure() {
+  size_t time1, time2;
+  REV_TIME( time1 );
+  check_count = 0;
+  for (int i=0; i<num_elements ;i++) {
+    dram_column[i] = int32_t( ( i * 7919 ) % 1000 ) - 500;
+    if (dram_column[i] >= lo && dram_column[i] <= hi)
+      check_count++;
+  }
+  REV_TIME( time2 );
+  return time2 - time1;
+}
+
+size_t theApp() {
+  size_t time1, time2;
+  REV_TIME( time1 );
+  // Indices of lo <= x <= hi
+  revpim::init(PIM::FUNC_NUM::U7, addr(dram_indices), addr(dram_column), addr(&sram[count_idx]),
+               PIM::filterCtrl(PIM::FILTER_OP::RANGE, PIM::EW_TYPE::I32, true), uint32_t(lo), uint32_t(hi),
+               num_elements);
+  revpim::run(PIM::FUNC_NUM::U7);
+  revpim::finish(PIM::FUNC_NUM::U7);
+  REV_TIME( time2 );
+  return time2 - time1;
+}
+
+size_t check() {
+  size_t time1, time2;
+  REV_TIME( time1 );
+  if (sram[count_idx] != uint64_t(check_count)) {
+    printf("Failed: count=%ld expected %d\n", sram[count_idx], check_count);
+    assert(false);
+  }
+  int k = 0;
+  for (int i=0; i<num_elements; i++) {
+    if (dram_column[i] < lo || dram_column[i] > hi)
+      continue;
+    if (dram_indices[k] != uint64_t(i)) {
+      printf("Failed: match %d index=%ld expected %d\n", k, dram_indices[k], i);
+      assert(false);
+    }
+    k++;
+  }
+  REV_TIME( time2 );
+  return time2 - time1;
+}
+
+int main( int argc, char** argv ) {
+  printf("Starting filter\n");
+  size_t time_id, time_config, time_exec, time_check;
+
+  printf("\nsram=0x%lx\ndram_column=0x%lx\ndram_indices=0x%lx\nnum_elements=%d\n", addr(sram), addr(dram_column), addr(dram_indices), num_elements);
+
+  printf("Checking PIM ID...\n");
+  time_id = checkPIM();
+  printf("Configuring...\n");
+  time_config = configure();
+  printf("Executing...\n");
+  time_exec = theApp();
+  printf("Checking...\n");
+  time_check = check();
+
+  printf("Results:\n");
+  printf("cycles: id_check=%d, config=%d, exec=%d, check=%d\n", time_id, time_config, time_exec, time_check);
+  printf("filter completed normally\n");
+  return 0;
+}
@@ -0,0 +1,116 @@
+/*
+ * gather.cpp
+ *
+ * Copyright (C) 2017-2024 Tactical Computing Laboratories, LLC
+ * All Rights Reserved
+ * contact@tactcomplabs.com
+ *
+ * See LICENSE in the top level directory for licensing details
+ */
+
+// Standard includes
+#include <cinttypes>
+#include <cstdlib>
+#include <cstring>
+
+// PIM definitions
+#include "revpim.h"
+
+// Globals
+const int num_elems = 512;
+const int table_size = 4096;
+uint64_t check_gather[num_elems];
+
+// PIM Memories (non-cachable)
+uint64_t dram_table[table_size] __attribute__((section(".pimdram")));
+uint64_t dram_copy[table_size] __attribute__((section(".pimdram")));
+uint32_t dram_idx[num_elems] __attribute__((section(".pimdram")));
+uint64_t dram_dst[num_elems] __attribute__((section(".pimdram")));
+uint64_t sram[PIM::SRAM_SIZE] __attribute__((section(".pimsram")));
+
+uint64_t addr(const void* p) {
+  return reinterpret_cast<uint64_t>(p);
+}
+
+size_t checkPIM() {
+  size_t time1, time2;
+  // sram offset 0 initialized by PIM hardware
+  REV_TIME( time1 );
+  if (sram[0] != ( uint64_t( PIM_TYPE_TCL ) << 56 )) {
+    printf("Unexpected PIM TYPE 0x%lx\n", sram[0]);
+    assert(false);
+  }
+  REV_TIME( time2 );
+  return time2 - time1;
+}
+
+size_t configure() {
+  size_t time1, time2;
+  REV_TIME( time1 );
+  for (int i=0; i<table_size ;i++) {
+    dram_table[i] = (0xfeed << 16) | i;
+    dram_copy[i] = 0;
+  }
+  // Irregular indices with repeats and some shared bursts
+  for (int i=0; i<num_elems ;i++) {
+    dram_idx[i] = (i * 2654435761u) % table_size;
+    if (i & 3)
+      dram_idx[i] = dram_idx[i - 1] ^ 1;
+    check_gather[i] = dram_table[dram_idx[i]];
+  }
+  REV_TIME( time2 );
+  return time2 - time1;
+}
+
+size_t theApp() {
+  size_t time1, time2;
+  REV_TIME( time1 );
+  // dst[i] = table[idx[i]]
+  revpim::init(PIM::FUNC_NUM::F6, addr(dram_dst), addr(dram_table), addr(dram_idx), num_elems, sizeof(uint64_t), sizeof(uint32_t));
+  revpim::run(PIM::FUNC_NUM::F6);
+  revpim::finish(PIM::FUNC_NUM::F6);
+  // copy[idx[i]] = dst[i]
+  revpim::init(PIM::FUNC_NUM::F7, addr(dram_copy), addr(dram_dst), addr(dram_idx), num_elems, sizeof(uint64_t), sizeof(uint32_t));
+  revpim::run(PIM::FUNC_NUM::F7);
+  revpim::finish(PIM::FUNC_NUM::F7);
+  REV_TIME( time2 );
+  return time2 - time1;
+}
+
+size_t check() {
+  size_t time1, time2;
+  REV_TIME( time1 );
+  for (int i=0; i<num_elems; i++) {
+    if (check_gather[i] != dram_dst[i]) {
+      printf("Failed: check_gather[%d]=0x%lx dram_dst[%d]=0x%lx\n", i, check_gather[i], i, dram_dst[i]);
+      assert(false);
+    }
+    if (dram_copy[dram_idx[i]] != dram_table[dram_idx[i]]) {
+      printf("Failed: scatter to %d\n", dram_idx[i]);
+      assert(false);
+    }
+  }
+  REV_TIME( time2 );
+  return time2 - time1;
+}
+
+int main( int argc, char** argv ) {
+  printf("Starting gather\n");
+  size_t time_id, time_config, time_exec, time_check;
+
+  printf("\ndram_table=0x%lx\ndram_idx=0x%lx\nnum_elems=%d\n", addr(dram_table), addr(dram_idx), num_elems);
+
+  printf("Checking PIM ID...\n");
+  time_id = checkPIM();
+  printf("Configuring...\n");
+  time_config = configure();
+  printf("Executing...\n");
+  time_exec = theApp();
+  printf("Checking...\n");
+  time_check = check();
+
+  printf("Results:\n");
+  printf("cycles: id_check=%d, config=%d, exec=%d, check=%d\n", time_id, time_config, time_exec, time_check);
+  printf("gather completed normally\n");
+  return 0;
+}
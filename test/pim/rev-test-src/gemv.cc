@@ -0,0 +1,134 @@
+/*
+ * gemv.cpp
+ *
+ * Copyright (C) 2017-2024 Tactical Computing Laboratories, LLC
+ * All Rights Reserved
+ * contact@tactcomplabs.com
+ *
+ * See LICENSE in the top level directory for licensing details
+ */
+
+// Standard includes
+#include <cinttypes>
+#include <cstdlib>
+#include <cstring>
+
+// PIM definitions
+#include "revpim.h"
+
+// Globals
+const int rows = 64;
+const int cols = 256;           // int8 GEMV
+const int fcols = 32;           // fp32 GEMM with n columns of B
+const int n = 2;
+int32_t check_y[rows];
+float check_z[rows * n];
+
+// PIM Memories (non-cachable)
+int8_t  dram_w[rows * cols] __attribute__((section(".pimdram")));
+float   dram_fw[rows * fcols] __attribute__((section(".pimdram")));
+int32_t dram_y[rows] __attribute__((section(".pimdram")));
+float   dram_z[rows * n] __attribute__((section(".pimdram")));
+uint64_t sram[PIM::SRAM_SIZE] __attribute__((section(".pimsram")));
+
+// SRAM layout: x for the GEMV, then the B tile
+const int x_idx = 8;
+const int b_idx = x_idx + cols / 8;
+
+uint64_t addr(const void* p) {
+  return reinterpret_cast<uint64_t>(p);
+}
+
+size_t checkPIM() {
+  size_t time1, time2;
+  // sram offset 0 initialized by PIM hardware
+  REV_TIME( time1 );
+  if (sram[0] != ( uint64_t( PIM_TYPE_TCL ) << 56 )) {
+    printf("Unexpected PIM TYPE 0x%lx\n", sram[0]);
+    assert(false);
+  }
+  REV_TIME( time2 );
+  return time2 - time1;
+}
+
+size_t configure() {
+  size_t time1, time2;
+  REV_TIME( time1 );
+  int8_t* x = reinterpret_cast<int8_t*>(&sram[x_idx]);
+  float* b = reinterpret_cast<float*>(&sram[b_idx]);
+  for (int k=0; k<cols ;k++)
+    x[k] = int8_t( ( k * 37 ) % 255 - 127 );
+  for (int k=0; k<fcols * n ;k++)
+    b[k] = float( k % 7 ) - 3;
+  for (int r=0; r<rows ;r++) {
+    check_y[r] = 0;
+    for (int k=0; k<cols ;k++) {
+      dram_w[r * cols + k] = int8_t( ( r * 11 + k * 5 ) % 255 - 127 );
+      check_y[r] += int32_t( dram_w[r * cols + k] ) * int32_t( x[k] );
+    }
+    for (int k=0; k<fcols ;k++)
+      dram_fw[r * fcols + k] = float( ( r + k ) % 5 ) - 2;
+    for (int j=0; j<n ;j++) {
+      check_z[r * n + j] = 0;
+      for (int k=0; k<fcols ;k++)
+        check_z[r * n + j] += dram_fw[r * fcols + k] * b[k * n + j];
+    }
+  }
+  REV_TIME( time2 );
+  return time2 - time1;
+}
+
+size_t theApp() {
+  size_t time1, time2;
+  REV_TIME( time1 );
+  revpim::init(PIM::FUNC_NUM::U10, addr(dram_y), addr(dram_w), addr(&sram[x_idx]), rows, cols,
+               PIM::gemvCtrl(PIM::EW_TYPE::I8), 0);
+  revpim::run(PIM::FUNC_NUM::U10);
+  revpim::finish(PIM::FUNC_NUM::U10);
+  revpim::init(PIM::FUNC_NUM::U10, addr(dram_z), addr(dram_fw), addr(&sram[b_idx]), rows, fcols,
+               PIM::gemvCtrl(PIM::EW_TYPE::F32, n), 0);
+  revpim::run(PIM::FUNC_NUM::U10);
+  revpim::finish(PIM::FUNC_NUM::U10);
+  REV_TIME( time2 );
+  return time2 - time1;
+}
+
+size_t check() {
+  size_t time1, time2;
+  REV_TIME( time1 );
+  for (int r=0; r<rows; r++) {
+    if (dram_y[r] != check_y[r]) {
+      printf("Failed: y[%d]=%d expected %d\n", r, dram_y[r], check_y[r]);
+      assert(false);
+    }
+    for (int j=0; j<n; j++) {
+      if (dram_z[r * n + j] != check_z[r * n + j]) {
+        printf("Failed: z[%d][%d]=%f expected %f\n", r, j, dram_z[r * n + j], check_z[r * n + j]);
+        assert(false);
+      }
+    }
+  }
+  REV_TIME( time2 );
+  return time2 - time1;
+}
+
+int main( int argc, char** argv ) {
+  printf("Starting gemv\n");
+  size_t time_id, time_config, time_exec, time_check;
+
+  printf("\nsram=0x%lx\ndram_w=0x%lx\ndram_y=0x%lx\nrows=%d\n", addr(sram), addr(dram_w), addr(dram_y), rows);
+
+  printf("Checking PIM ID...\n");
+  time_id = checkPIM();
+  printf("Configuring...\n");
+  time_config = configure();
+  printf("Executing...\n");
+  time_exec = theApp();
+  printf("Checking...\n");
+  time_check = check();
+
+  printf("Results:\n");
+  printf("cycles: id_check=%d, config=%d, exec=%d, check=%d\n", time_id, time_config, time_exec, time_check);
+  printf("gemv completed normally\n");
+  return 0;
+}
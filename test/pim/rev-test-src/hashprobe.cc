@@ -0,0 +1,126 @@
+/*
+ * hashprobe.cpp
+ *
+ * Copyright (C) 2017-2024 Tactical Computing Laboratories, LLC
+ * All Rights Reserved
+ * contact@tactcomplabs.com
+ *
+ * See LICENSE in the top level directory for licensing details
+ */
+
+// Standard includes
+#include <cinttypes>
+#include <cstdlib>
+#include <cstring>
+
+// PIM definitions
+#include "revpim.h"
+
+// Globals
+const int num_buckets = 512;    // power of 2
+const int num_entries = 300;
+const int num_keys = 32;
+const uint64_t empty_key = ~0ull;
+const uint64_t miss = 0xdeadbeef;
+uint64_t check_values[num_keys];
+
+// PIM Memories (non-cachable)
+struct bucket_t {
+  uint64_t key;
+  uint64_t value;
+};
+bucket_t dram_table[num_buckets] __attribute__((section(".pimdram")));
+uint64_t sram[PIM::SRAM_SIZE] __attribute__((section(".pimsram")));
+
+// SRAM layout: key batch then values
+const int keys_idx = 8;
+const int values_idx = keys_idx + num_keys;
+
+uint64_t addr(const void* p) {
+  return reinterpret_cast<uint64_t>(p);
+}
+
+size_t checkPIM() {
+  size_t time1, time2;
+  // sram offset 0 initialized by PIM hardware
+  REV_TIME( time1 );
+  if (sram[0] != ( uint64_t( PIM_TYPE_TCL ) << 56 )) {
+    printf("Unexpected PIM TYPE 0x%lx\n", sram[0]);
+    assert(false);
+  }
+  REV_TIME( time2 );
+  return time2 - time1;
+}
+
+uint64_t entryKey(int e) {
+  return 0x1000 + 17 * e;
+}
+
+size_t configure() {
+  size_t time1, time2;
+  REV_TIME( time1 );
+  // Open addressing with linear probing, same hash as the PIM
+  for (int b=0; b<num_buckets ;b++)
+    dram_table[b].key = empty_key;
+  for (int e=0; e<num_entries ;e++) {
+    uint64_t k = entryKey(e);
+    uint64_t b = PIM::hashKey(k) & (num_buckets - 1);
+    while (dram_table[b].key != empty_key)
+      b = (b + 1) & (num_buckets - 1);
+    dram_table[b].key = k;
+    dram_table[b].value = k * 3;
+  }
+  // Every fourth key misses
+  for (int i=0; i<num_keys ;i++) {
+    uint64_t k = (i & 3) ? entryKey(i * 9) : entryKey(i) + 1;
+    sram[keys_idx + i] = k;
+    check_values[i] = (i & 3) ? k * 3 : miss;
+  }
+  REV_TIME( time2 );
+  return time2 - time1;
+}
+
+size_t theApp() {
+  size_t time1, time2;
+  REV_TIME( time1 );
+  revpim::init(PIM::FUNC_NUM::U4, addr(&sram[values_idx]), addr(&sram[keys_idx]), num_keys, addr(dram_table),
+               num_buckets, static_cast<uint64_t>(PIM::HASH_MODE::OPEN), empty_key, miss);
+  revpim::run(PIM::FUNC_NUM::U4);
+  revpim::finish(PIM::FUNC_NUM::U4);
+  REV_TIME( time2 );
+  return time2 - time1;
+}
+
+size_t check() {
+  size_t time1, time2;
+  REV_TIME( time1 );
+  for (int i=0; i<num_keys; i++) {
+    if (sram[values_idx + i] != check_values[i]) {
+      printf("Failed: key 0x%lx value=0x%lx expected 0x%lx\n", sram[keys_idx + i], sram[values_idx + i], check_values[i]);
+      assert(false);
+    }
+  }
+  REV_TIME( time2 );
+  return time2 - time1;
+}
+
+int main( int argc, char** argv ) {
+  printf("Starting hashprobe\n");
+  size_t time_id, time_config, time_exec, time_check;
+
+  printf("\nsram=0x%lx\ndram_table=0x%lx\nnum_keys=%d\n", addr(sram), addr(dram_table), num_keys);
+
+  printf("Checking PIM ID...\n");
+  time_id = checkPIM();
+  printf("Configuring...\n");
+  time_config = configure();
+  printf("Executing...\n");
+  time_exec = theApp();
+  printf("Checking...\n");
+  time_check = check();
+
+  printf("Results:\n");
+  printf("cycles: id_check=%d, config=%d, exec=%d, check=%d\n", time_id, time_config, time_exec, time_check);
+  printf("hashprobe completed normally\n");
+  return 0;
+}
@@ -0,0 +1,125 @@
+/*
+ * histogram.cpp
+ *
+ * Copyright (C) 2017-2024 Tactical Computing Laboratories, LLC
+ * All Rights Reserved
+ * contact@tactcomplabs.com
+ *
+ * See LICENSE in the top level directory for licensing details
+ */
+
+// Standard includes
+#include <cinttypes>
+#include <cstdlib>
+#include <cstring>
+
+// PIM definitions
+#include "revpim.h"
+
+// Globals
+const int num_records = 2000;
+const int num_groups = 32;      // fits SRAM
+const int num_bins = 512;       // spills out of SRAM
+uint64_t check_sums[num_groups];
+uint64_t check_counts[num_bins];
+
+// PIM Memories (non-cachable)
+uint64_t dram_keys[num_records] __attribute__((section(".pimdram")));
+uint64_t dram_values[num_records] __attribute__((section(".pimdram")));
+uint64_t dram_sums[num_groups] __attribute__((section(".pimdram")));
+uint64_t dram_counts[num_bins] __attribute__((section(".pimdram")));
+uint64_t sram[PIM::SRAM_SIZE] __attribute__((section(".pimsram")));
+
+// SRAM layout: bins run from here to the end of SRAM
+const int bins_idx = 8;
+
+uint64_t addr(const void* p) {
+  return reinterpret_cast<uint64_t>(p);
+}
+
+size_t checkPIM() {
+  size_t time1, time2;
+  // sram offset 0 initialized by PIM hardware
+  REV_TIME( time1 );
+  if (sram[0] != ( uint64_t( PIM_TYPE_TCL ) << 56 )) {
+    printf("Unexpected PIM TYPE 0x%lx\n", sram[0]);
+    assert(false);
+  }
+  REV_TIME( time2 );
+  return time2 - time1;
+}
+
+size_t configure() {
+  size_t time1, time2;
+  REV_TIME( time1 );
+  for (int g=0; g<num_groups ;g++)
+    check_sums[g] = 0;
+  for (int b=0; b<num_bins ;b++)
+    check_counts[b] = 0;
+  for (int i=0; i<num_records ;i++) {
+    dram_keys[i] = ( uint64_t(i) * 7919 ) % num_bins;
+    dram_values[i] = i;
+    check_counts[dram_keys[i]]++;
+    // Group by the key's upper bits: shift of 4 gives 32 groups
+    check_sums[dram_keys[i] >> 4] += i;
+  }
+  REV_TIME( time2 );
+  return time2 - time1;
+}
+
+size_t theApp() {
+  size_t time1, time2;
+  REV_TIME( time1 );
+  // Group-by sum, every group held in SRAM
+  revpim::init(PIM::FUNC_NUM::U8, addr(dram_sums), addr(dram_keys), addr(dram_values), num_records, num_groups,
+               PIM::histCtrl(PIM::HIST_OP::SUM, 4), addr(&sram[bins_idx]), 0);
+  revpim::run(PIM::FUNC_NUM::U8);
+  revpim::finish(PIM::FUNC_NUM::U8);
+  // Histogram with more bins than SRAM words
+  revpim::init(PIM::FUNC_NUM::U8, addr(dram_counts), addr(dram_keys), 0, num_records, num_bins,
+               PIM::histCtrl(PIM::HIST_OP::COUNT), addr(&sram[bins_idx]), 0);
+  revpim::run(PIM::FUNC_NUM::U8);
+  revpim::finish(PIM::FUNC_NUM::U8);
+  REV_TIME( time2 );
+  return time2 - time1;
+}
+
+size_t check() {
+  size_t time1, time2;
+  REV_TIME( time1 );
+  for (int g=0; g<num_groups; g++) {
+    if (dram_sums[g] != check_sums[g]) {
+      printf("Failed: group %d sum=%ld expected %ld\n", g, dram_sums[g], check_sums[g]);
+      assert(false);
+    }
+  }
+  for (int b=0; b<num_bins; b++) {
+    if (dram_counts[b] != check_counts[b]) {
+      printf("Failed: bin %d count=%ld expected %ld\n", b, dram_counts[b], check_counts[b]);
+      assert(false);
+    }
+  }
+  REV_TIME( time2 );
+  return time2 - time1;
+}
+
+int main( int argc, char** argv ) {
+  printf("Starting histogram\n");
+  size_t time_id, time_config, time_exec, time_check;
+
+  printf("\nsram=0x%lx\ndram_keys=0x%lx\ndram_counts=0x%lx\nnum_records=%d\n", addr(sram), addr(dram_keys), addr(dram_counts), num_records);
+
+  printf("Checking PIM ID...\n");
+  time_id = checkPIM();
+  printf("Configuring...\n");
+  time_config = configure();
+  printf("Executing...\n");
+  time_exec = theApp();
+  printf("Checking...\n");
+  time_check = check();
+
+  printf("Results:\n");
+  printf("cycles: id_check=%d, config=%d, exec=%d, check=%d\n", time_id, time_config, time_exec, time_check);
+  printf("histogram completed normally\n");
+  return 0;
+}
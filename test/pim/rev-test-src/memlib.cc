@@ -0,0 +1,140 @@
+/*
+ * memlib.cpp
+ *
+ * Copyright (C) 2017-2024 Tactical Computing Laboratories, LLC
+ * All Rights Reserved
+ * contact@tactcomplabs.com
+ *
+ * See LICENSE in the top level directory for licensing details
+ */
+
+// Standard includes
+#include <cinttypes>
+#include <cstdlib>
+#include <cstring>
+
+// PIM definitions
+#include "revpim.h"
+
+// Globals
+const int num_bytes = 4096;
+const int diff_pos = 2500;
+const int match_pos = 3000;
+const char needle[] = "near memory search";
+const int needle_bytes = sizeof(needle) - 1;
+
+// PIM Memories (non-cachable)
+uint8_t dram_fill[num_bytes] __attribute__((section(".pimdram")));
+uint8_t dram_a[num_bytes] __attribute__((section(".pimdram")));
+uint8_t dram_b[num_bytes] __attribute__((section(".pimdram")));
+uint64_t sram[PIM::SRAM_SIZE] __attribute__((section(".pimsram")));
+
+// SRAM layout: memcmp result and offset, memchr offset, memmem offset, needle
+const int cmp_idx = 8;
+const int chr_idx = 10;
+const int mem_idx = 11;
+const int needle_idx = 16;
+
+uint64_t addr(const void* p) {
+  return reinterpret_cast<uint64_t>(p);
+}
+
+size_t checkPIM() {
+  size_t time1, time2;
+  // sram offset 0 initialized by PIM hardware
+  REV_TIME( time1 );
+  if (sram[0] != ( uint64_t( PIM_TYPE_TCL ) << 56 )) {
+    printf("Unexpected PIM TYPE 0x%lx\n", sram[0]);
+    assert(false);
+  }
+  REV_TIME( time2 );
+  return time2 - time1;
+}
+
+size_t configure() {
+  size_t time1, time2;
+  REV_TIME( time1 );
+  for (int i=0; i<num_bytes; i++) {
+    dram_a[i] = uint8_t( 'a' + ( i % 26 ) );
+    dram_b[i] = dram_a[i];
+  }
+  dram_b[diff_pos] = '#';
+  memcpy(&dram_a[match_pos], needle, needle_bytes);
+  // SRAM takes whole words
+  uint64_t words[( needle_bytes + 7 ) / 8] = { 0 };
+  memcpy(words, needle, needle_bytes);
+  for (unsigned w=0; w<sizeof(words)/8; w++)
+    sram[needle_idx+w] = words[w];
+  REV_TIME( time2 );
+  return time2 - time1;
+}
+
+size_t theApp() {
+  size_t time1, time2;
+  REV_TIME( time1 );
+  // memset(dram_fill, 0x5a, num_bytes)
+  revpim::init(PIM::FUNC_NUM::F2, addr(dram_fill), 0x5a, num_bytes, 1);
+  revpim::run(PIM::FUNC_NUM::F2);
+  // memcmp(dram_a, dram_b, num_bytes)
+  revpim::init(PIM::FUNC_NUM::F3, addr(&sram[cmp_idx]), addr(dram_a), addr(dram_b), num_bytes);
+  revpim::run(PIM::FUNC_NUM::F3);
+  // memchr(dram_a, '#', num_bytes) finds nothing
+  revpim::init(PIM::FUNC_NUM::F4, addr(&sram[chr_idx]), addr(dram_a), num_bytes, '#', 1);
+  revpim::run(PIM::FUNC_NUM::F4);
+  revpim::finish(PIM::FUNC_NUM::F4);
+  // memmem(dram_a, num_bytes, needle, needle_bytes)
+  revpim::init(PIM::FUNC_NUM::F4, addr(&sram[mem_idx]), addr(dram_a), num_bytes, addr(&sram[needle_idx]), needle_bytes);
+  revpim::run(PIM::FUNC_NUM::F4);
+  revpim::finish(PIM::FUNC_NUM::F2);
+  revpim::finish(PIM::FUNC_NUM::F3);
+  revpim::finish(PIM::FUNC_NUM::F4);
+  REV_TIME( time2 );
+  return time2 - time1;
+}
+
+size_t check() {
+  size_t time1, time2;
+  REV_TIME( time1 );
+  for (int i=0; i<num_bytes; i++) {
+    if (dram_fill[i] != 0x5a) {
+      printf("Failed: fill[%d]=0x%x\n", i, dram_fill[i]);
+      assert(false);
+    }
+  }
+  int64_t expected = int64_t( dram_a[diff_pos] ) - int64_t( '#' );
+  if (int64_t(sram[cmp_idx]) != expected || sram[cmp_idx+1] != diff_pos) {
+    printf("Failed: memcmp=%ld at %ld expected %ld at %d\n", sram[cmp_idx], sram[cmp_idx+1], expected, diff_pos);
+    assert(false);
+  }
+  if (sram[chr_idx] != num_bytes) {
+    printf("Failed: memchr found a match at %ld\n", sram[chr_idx]);
+    assert(false);
+  }
+  if (sram[mem_idx] != match_pos) {
+    printf("Failed: memmem=%ld expected %d\n", sram[mem_idx], match_pos);
+    assert(false);
+  }
+  REV_TIME( time2 );
+  return time2 - time1;
+}
+
+int main( int argc, char** argv ) {
+  printf("Starting memlib\n");
+  size_t time_id, time_config, time_exec, time_check;
+
+  printf("\nsram=0x%lx\ndram_fill=0x%lx\ndram_a=0x%lx\ndram_b=0x%lx\nnum_bytes=%d\n", addr(sram), addr(dram_fill), addr(dram_a), addr(dram_b), num_bytes);
+
+  printf("Checking PIM ID...\n");
+  time_id = checkPIM();
+  printf("Configuring...\n");
+  time_config = configure();
+  printf("Executing...\n");
+  time_exec = theApp();
+  printf("Checking...\n");
+  time_check = check();
+
+  printf("Results:\n");
+  printf("cycles: id_check=%d, config=%d, exec=%d, check=%d\n", time_id, time_config, time_exec, time_check);
+  printf("memlib completed normally\n");
+  return 0;
+}
@@ -0,0 +1,139 @@
+/*
+ * reduce.cpp
+ *
+ * Copyright (C) 2017-2024 Tactical Computing Laboratories, LLC
+ * All Rights Reserved
+ * contact@tactcomplabs.com
+ *
+ * See LICENSE in the top level directory for licensing details
+ */
+
+// Standard includes
+#include <cinttypes>
+#include <cstdlib>
+#include <cstring>
+
+// PIM definitions
+#include "revpim.h"
+
+// Globals
+const int num_elems = 512;
+int64_t check_sum, check_dot, check_max;
+uint64_t check_argmax;
+int64_t check_scan[num_elems];
+
+// PIM Memories (non-cachable)
+int64_t dram_a[num_elems] __attribute__((section(".pimdram")));
+int64_t dram_b[num_elems] __attribute__((section(".pimdram")));
+int64_t dram_scan[num_elems] __attribute__((section(".pimdram")));
+uint64_t sram[PIM::SRAM_SIZE] __attribute__((section(".pimsram")));
+
+// SRAM result slots
+const int sum_idx = 8;
+const int dot_idx = 9;
+const int max_idx = 10;  // value, index
+
+uint64_t addr(const void* p) {
+  return reinterpret_cast<uint64_t>(p);
+}
+
+size_t checkPIM() {
+  size_t time1, time2;
+  // sram offset 0 initialized by PIM hardware
+  REV_TIME( time1 );
+  if (sram[0] != ( uint64_t( PIM_TYPE_TCL ) << 56 )) {
+    printf("Unexpected PIM TYPE 0x%lx\n", sram[0]);
+    assert(false);
+  }
+  REV_TIME( time2 );
+  return time2 - time1;
+}
+
+size_t configure() {
+  size_t time1, time2;
+  REV_TIME( time1 );
+  check_sum = check_dot = 0;
+  check_max = 0;
+  check_argmax = 0;
+  for (int i=0; i<num_elems ;i++) {
+    dram_a[i] = (i * 37) % 1001 - 500;
+    dram_b[i] = (i * 13) % 61 - 30;
+    check_sum += dram_a[i];
+    check_dot += dram_a[i] * dram_b[i];
+    check_scan[i] = check_sum;
+    if (i == 0 || dram_a[i] > check_max) {
+      check_max = dram_a[i];
+      check_argmax = i;
+    }
+  }
+  REV_TIME( time2 );
+  return time2 - time1;
+}
+
+size_t theApp() {
+  size_t time1, time2;
+  const PIM::EW_TYPE ty = PIM::EW_TYPE::I64;
+  REV_TIME( time1 );
+  // Only the 8-byte results cross back to the host
+  revpim::init(PIM::FUNC_NUM::U1, addr(&sram[sum_idx]), addr(dram_a), 0, PIM::redCtrl(PIM::RED_OP::SUM, ty), sizeof(dram_a));
+  revpim::run(PIM::FUNC_NUM::U1);
+  revpim::finish(PIM::FUNC_NUM::U1);
+  revpim::init(PIM::FUNC_NUM::U1, addr(&sram[dot_idx]), addr(dram_a), addr(dram_b), PIM::redCtrl(PIM::RED_OP::DOT, ty), sizeof(dram_a));
+  revpim::run(PIM::FUNC_NUM::U1);
+  revpim::finish(PIM::FUNC_NUM::U1);
+  revpim::init(PIM::FUNC_NUM::U1, addr(&sram[max_idx]), addr(dram_a), 0, PIM::redCtrl(PIM::RED_OP::ARGMAX, ty), sizeof(dram_a));
+  revpim::run(PIM::FUNC_NUM::U1);
+  // Inclusive prefix sum runs alongside the last reduction
+  revpim::init(PIM::FUNC_NUM::U2, addr(dram_scan), addr(dram_a), PIM::redCtrl(PIM::RED_OP::SUM, ty), sizeof(dram_a));
+  revpim::run(PIM::FUNC_NUM::U2);
+  revpim::finish(PIM::FUNC_NUM::U1);
+  revpim::finish(PIM::FUNC_NUM::U2);
+  REV_TIME( time2 );
+  return time2 - time1;
+}
+
+size_t check() {
+  size_t time1, time2;
+  REV_TIME( time1 );
+  if (static_cast<int64_t>(sram[sum_idx]) != check_sum) {
+    printf("Failed: sum=%ld expected %ld\n", sram[sum_idx], check_sum);
+    assert(false);
+  }
+  if (static_cast<int64_t>(sram[dot_idx]) != check_dot) {
+    printf("Failed: dot=%ld expected %ld\n", sram[dot_idx], check_dot);
+    assert(false);
+  }
+  if (static_cast<int64_t>(sram[max_idx]) != check_max || sram[max_idx + 1] != check_argmax) {
+    printf("Failed: max=%ld at %ld expected %ld at %ld\n", sram[max_idx], sram[max_idx + 1], check_max, check_argmax);
+    assert(false);
+  }
+  for (int i=0; i<num_elems; i++) {
+    if (check_scan[i] != dram_scan[i]) {
+      printf("Failed: check_scan[%d]=%ld dram_scan[%d]=%ld\n", i, check_scan[i], i, dram_scan[i]);
+      assert(false);
+    }
+  }
+  REV_TIME( time2 );
+  return time2 - time1;
+}
+
+int main( int argc, char** argv ) {
+  printf("Starting reduce\n");
+  size_t time_id, time_config, time_exec, time_check;
+
+  printf("\nsram=0x%lx\ndram_a=0x%lx\nnum_elems=%d\n", addr(sram), addr(dram_a), num_elems);
+
+  printf("Checking PIM ID...\n");
+  time_id = checkPIM();
+  printf("Configuring...\n");
+  time_config = configure();
+  printf("Executing...\n");
+  time_exec = theApp();
+  printf("Checking...\n");
+  time_check = check();
+
+  printf("Results:\n");
+  printf("cycles: id_check=%d, config=%d, exec=%d, check=%d\n", time_id, time_config, time_exec, time_check);
+  printf("reduce completed normally\n");
+  return 0;
+}
@@ -21,6 +21,8 @@ using namespace SST;
 namespace revpim {
 
 volatile uint64_t func[PIM::FUNC_SIZE] __attribute__((section(".func_base")));
+volatile uint64_t ctrl[PIM::CTRL_SIZE] __attribute__((section(".ctrl_base")));
+volatile uint64_t func_wait[PIM::FUNC_WAIT_SIZE] __attribute__((section(".func_wait")));
 
 //
 // Initialization functions
@@ -59,6 +61,19 @@ void run(PIM::FUNC_NUM f) {
 }
 
 void finish(PIM::FUNC_NUM f) {
+    unsigned f_idx = static_cast<unsigned>(f);
+    assert(f_idx<PIM::FUNC_SIZE);
+    // The PIM holds the response to a wait register read until the function is done
+    PIM::FSTATE state = static_cast<PIM::FSTATE>(func_wait[f_idx]);
+    if (state == PIM::FSTATE::INVALID) {
+        assert(false);
+    }
+    assert(state == PIM::FSTATE::DONE);
+    return;
+}
+
+// Original polling loop on the status register
+void finish_poll(PIM::FUNC_NUM f) {
     unsigned f_idx = static_cast<unsigned>(f);
     assert(f_idx<PIM::FUNC_SIZE);
     PIM::FSTATE state = static_cast<PIM::FSTATE>(func[f_idx]);
@@ -73,6 +88,89 @@ void finish(PIM::FUNC_NUM f) {
     return;
 }
 
+//
+// Descriptor ring functions
+//
+struct ring_t {
+    volatile uint64_t* base = nullptr;
+    unsigned size = 0;
+    unsigned head = 0;
+    uint64_t deps = 0;  // dependency mask for the next push
+} ring;
+
+void ring_init(volatile uint64_t* base, unsigned words) {
+    ring.base = base;
+    ring.size = words;
+    ring.head = 0;
+    ctrl[static_cast<unsigned>(PIM::CTRL_REG::RING_BASE)] = reinterpret_cast<uint64_t>(base);
+    ctrl[static_cast<unsigned>(PIM::CTRL_REG::RING_SIZE)] = words;
+}
+
+// Publish queued descriptors to the PIM
+void ring_doorbell() {
+    ctrl[static_cast<unsigned>(PIM::CTRL_REG::RING_HEAD)] = ring.head;
+}
+
+// Make the next pushed descriptor wait on earlier ones. Bit i is the
+// descriptor i+1 pushes back. The PIM resolves the dependency itself.
+void ring_depends(uint64_t mask) {
+    ring.deps = mask;
+}
+
+// Queue a descriptor. cpl (PIM SRAM, may be null) is set to FSTATE::DONE when the function finishes.
+void ring_push(PIM::FUNC_NUM f, volatile uint64_t* cpl, unsigned nargs, const uint64_t* args) {
+    assert(nargs <= PIM::NUM_FUNC_PARAMS);
+    unsigned cpl_slot = 0;
+    if (cpl) {
+        *cpl = 0;
+        cpl_slot = (reinterpret_cast<uint64_t>(cpl) - PIM::SRAM_BASE) / sizeof(uint64_t);
+    }
+    unsigned words = nargs + 1 + (ring.deps ? 1 : 0);
+    assert(words < ring.size);
+    // Keep one word free so head==tail means empty. Ring the doorbell before waiting for space.
+    unsigned tail = ctrl[static_cast<unsigned>(PIM::CTRL_REG::RING_TAIL)];
+    if ((ring.head + ring.size - tail) % ring.size + words >= ring.size) {
+        ring_doorbell();
+        do {
+            tail = ctrl[static_cast<unsigned>(PIM::CTRL_REG::RING_TAIL)];
+        } while ((ring.head + ring.size - tail) % ring.size + words >= ring.size);
+    }
+    ring.base[ring.head] = PIM::descHeader(f, nargs, cpl_slot, ring.deps != 0);
+    ring.head = (ring.head + 1) % ring.size;
+    if (ring.deps) {
+        ring.base[ring.head] = ring.deps;
+        ring.head = (ring.head + 1) % ring.size;
+        ring.deps = 0;
+    }
+    for (unsigned i = 0; i < nargs; i++) {
+        ring.base[ring.head] = args[i];
+        ring.head = (ring.head + 1) % ring.size;
+    }
+}
+
+void ring_push(PIM::FUNC_NUM f, volatile uint64_t* cpl, uint64_t* ptr0, uint64_t* ptr1, size_t sz) {
+    uint64_t args[3] = { reinterpret_cast<uint64_t>(ptr0), reinterpret_cast<uint64_t>(ptr1), sz };
+    ring_push(f, cpl, 3, args);
+}
+
+void ring_push(PIM::FUNC_NUM f, volatile uint64_t* cpl, uint64_t* ptr0, uint64_t* ptr1, uint64_t scalar, size_t sz) {
+    uint64_t args[4] = { reinterpret_cast<uint64_t>(ptr0), reinterpret_cast<uint64_t>(ptr1), scalar, sz };
+    ring_push(f, cpl, 4, args);
+}
+
+// Poll a completion slot
+void ring_wait(volatile uint64_t* cpl) {
+    while (static_cast<PIM::FSTATE>(*cpl) != PIM::FSTATE::DONE)
+        ;
+}
+
+// Single blocking read. Returns once the ring is drained and no function is running.
+void ring_drain() {
+    ring_doorbell();
+    uint64_t tail = ctrl[static_cast<unsigned>(PIM::CTRL_REG::RING_WAIT)];
+    assert(tail == ring.head);
+}
+
 } //namespace revpim
 
 #endif // _SST_REVPIM_H_
\ No newline at end of file
@@ -0,0 +1,126 @@
+/*
+ * ringidle.cpp
+ *
+ * Copyright (C) 2017-2024 Tactical Computing Laboratories, LLC
+ * All Rights Reserved
+ * contact@tactcomplabs.com
+ *
+ * See LICENSE in the top level directory for licensing details
+ */
+
+// Standard includes
+#include <cinttypes>
+#include <cstdlib>
+#include <cstring>
+
+// PIM definitions
+#include "revpim.h"
+
+// Globals
+const int xfr_size = 64;      // transfer size in dwords
+const int delay = 20000;      // host loop iterations with no PIM accesses
+volatile uint64_t spin;
+
+const uint64_t scalar = 3;
+
+// PIM Memories (non-cachable)
+uint64_t dram_dst[xfr_size] __attribute__((section(".pimdram")));
+uint64_t dram_mid[xfr_size] __attribute__((section(".pimdram")));
+uint64_t dram_src[xfr_size] __attribute__((section(".pimdram")));
+uint64_t sram[PIM::SRAM_SIZE] __attribute__((section(".pimsram")));
+
+// SRAM layout: descriptor ring and completion slots
+const int ring_idx = 64;
+const int ring_words = 16;
+const int cpl_idx = ring_idx + ring_words;
+
+size_t checkPIM() {
+  size_t time1, time2;
+  // sram offset 0 initialized by PIM hardware
+  REV_TIME( time1 );
+  if (sram[0] != ( uint64_t( PIM_TYPE_TCL ) << 56 )) {
+    printf("Unexpected PIM TYPE 0x%lx\n", sram[0]);
+    assert(false);
+  }
+  REV_TIME( time2 );
+  return time2 - time1;
+}
+
+size_t configure() {
+  size_t time1, time2;
+  REV_TIME( time1 );
+  for (int i=0; i<xfr_size ;i++)
+    dram_src[i] = (0xaced << 16) | i;
+  revpim::ring_init(&sram[ring_idx], ring_words);
+  REV_TIME( time2 );
+  return time2 - time1;
+}
+
+// Host work that leaves the PIM without any memory traffic to keep it clocked
+void hostWork() {
+  for (int i=0; i<delay; i++)
+    spin = spin + 1;
+}
+
+size_t theApp() {
+  size_t time1, time2;
+  REV_TIME( time1 );
+  // The launch itself must keep the PIM running until the copy completes
+  revpim::ring_push(PIM::FUNC_NUM::F1, &sram[cpl_idx], dram_dst, dram_src, xfr_size*sizeof(uint64_t));
+  revpim::ring_doorbell();
+  hostWork();
+  // Single read, no polling
+  if (static_cast<PIM::FSTATE>(sram[cpl_idx]) != PIM::FSTATE::DONE) {
+    printf("Failed: launch did not complete while the host was busy\n");
+    assert(false);
+  }
+  // A dependent stage starts in the cycle its input completes, with no
+  // host access to wake the PIM
+  revpim::ring_push(PIM::FUNC_NUM::F1, &sram[cpl_idx + 1], dram_mid, dram_src, xfr_size*sizeof(uint64_t));
+  revpim::ring_depends(1);
+  revpim::ring_push(PIM::FUNC_NUM::U5, &sram[cpl_idx + 2], dram_dst, dram_mid, scalar, xfr_size*sizeof(uint64_t));
+  revpim::ring_doorbell();
+  hostWork();
+  if (static_cast<PIM::FSTATE>(sram[cpl_idx + 2]) != PIM::FSTATE::DONE) {
+    printf("Failed: dependent launch did not complete while the host was busy\n");
+    assert(false);
+  }
+  REV_TIME( time2 );
+  return time2 - time1;
+}
+
+size_t check() {
+  size_t time1, time2;
+  REV_TIME( time1 );
+  for (int i=0; i<xfr_size; i++) {
+    if (scalar * dram_src[i] != dram_dst[i]) {
+      printf("Failed: dram_src[%d]=0x%lx dram_dst[%d]=0x%lx\n", i, dram_src[i], i, dram_dst[i]);
+      assert(false);
+    }
+  }
+  REV_TIME( time2 );
+  return time2 - time1;
+}
+
+int main( int argc, char** argv ) {
+  printf("Starting ringidle\n");
+  size_t time_id, time_config, time_exec, time_check;
+
+  printf("\nsram=0x%lx\ndram_dst=0x%lx\ndram_src=0x%lx\nxfr_size=%d\n",
+    reinterpret_cast<uint64_t>(sram), reinterpret_cast<uint64_t>(dram_dst), reinterpret_cast<uint64_t>(dram_src), xfr_size
+  );
+
+  printf("Checking PIM ID...\n");
+  time_id = checkPIM();
+  printf("Configuring...\n");
+  time_config = configure();
+  printf("Executing...\n");
+  time_exec = theApp();
+  printf("Checking...\n");
+  time_check = check();
+
+  printf("Results:\n");
+  printf("cycles: id_check=%d, config=%d, exec=%d, check=%d\n", time_id, time_config, time_exec, time_check);
+  printf("ringidle completed normally\n");
+  return 0;
+}
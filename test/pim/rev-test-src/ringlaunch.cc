@@ -0,0 +1,117 @@
+/*
+ * ringlaunch.cpp
+ *
+ * Copyright (C) 2017-2024 Tactical Computing Laboratories, LLC
+ * All Rights Reserved
+ * contact@tactcomplabs.com
+ *
+ * See LICENSE in the top level directory for licensing details
+ */
+
+// Standard includes
+#include <cinttypes>
+#include <cstdlib>
+#include <cstring>
+
+// PIM definitions
+#include "revpim.h"
+
+// Globals
+const int xfr_size = 256;     // total transfer size in dwords
+const int num_desc = 8;       // descriptors per batch
+const int blk_size = xfr_size / num_desc;
+const uint64_t scalar = 3;
+uint64_t check_data[xfr_size];
+
+// PIM Memories (non-cachable)
+uint64_t dram_dst[xfr_size] __attribute__((section(".pimdram")));
+uint64_t dram_src[xfr_size] __attribute__((section(".pimdram")));
+uint64_t sram[PIM::SRAM_SIZE] __attribute__((section(".pimsram")));
+
+// SRAM layout: descriptor ring and completion slots
+const int ring_idx = 64;
+const int ring_words = 32;
+const int cpl_idx = ring_idx + ring_words;
+
+size_t checkPIM() {
+  size_t time1, time2;
+  // sram offset 0 initialized by PIM hardware
+  REV_TIME( time1 );
+  if (sram[0] != ( uint64_t( PIM_TYPE_TCL ) << 56 )) {
+    printf("Unexpected PIM TYPE 0x%lx\n", sram[0]);
+    assert(false);
+  }
+  REV_TIME( time2 );
+  return time2 - time1;
+}
+
+size_t configure() {
+  size_t time1, time2;
+  REV_TIME( time1 );
+  // Generate source and check data. Odd blocks are scaled by U5.
+  for (int i=0; i<xfr_size ;i++) {
+    uint64_t d = (0xaced << 16) | i;
+    check_data[i] = ((i / blk_size) & 1) ? scalar * d : d;
+    dram_src[i] = d;
+  }
+  revpim::ring_init(&sram[ring_idx], ring_words);
+  REV_TIME( time2 );
+  return time2 - time1;
+}
+
+size_t theApp() {
+  size_t time1, time2;
+  REV_TIME( time1 );
+  // Queue the whole batch and ring the doorbell once
+  for (int d=0; d<num_desc; d++) {
+    uint64_t* dst = &dram_dst[d * blk_size];
+    uint64_t* src = &dram_src[d * blk_size];
+    if (d & 1)
+      revpim::ring_push(PIM::FUNC_NUM::U5, &sram[cpl_idx + d], dst, src, scalar, blk_size*sizeof(uint64_t));
+    else
+      revpim::ring_push(PIM::FUNC_NUM::F1, &sram[cpl_idx + d], dst, src, blk_size*sizeof(uint64_t));
+  }
+  revpim::ring_doorbell();
+  // Each slot drains in order so the last descriptor of each function finishes last
+  revpim::ring_wait(&sram[cpl_idx + num_desc - 2]);
+  revpim::ring_wait(&sram[cpl_idx + num_desc - 1]);
+  REV_TIME( time2 );
+  return time2 - time1;
+}
+
+size_t check() {
+  size_t time1, time2;
+  REV_TIME( time1 );
+  for (int i=0; i<xfr_size; i++) {
+    if (check_data[i] != dram_dst[i]) {
+      printf("Failed: check_data[%d]=0x%lx dram_dst[%d]=0x%lx\n",
+              i, check_data[i], i, dram_dst[i]);
+      assert(false);
+    }
+  }
+  REV_TIME( time2 );
+  return time2 - time1;
+}
+
+int main( int argc, char** argv ) {
+  printf("Starting ringlaunch\n");
+  size_t time_id, time_config, time_exec, time_check;
+
+  printf("\nsram=0x%lx\ndram_dst=0x%lx\ndram_src=0x%lx\nxfr_size=%d\nnum_desc=%d\n",
+    reinterpret_cast<uint64_t>(sram), reinterpret_cast<uint64_t>(dram_dst), reinterpret_cast<uint64_t>(dram_src), xfr_size, num_desc
+  );
+
+  printf("Checking PIM ID...\n");
+  time_id = checkPIM();
+  printf("Configuring...\n");
+  time_config = configure();
+  printf("Executing...\n");
+  time_exec = theApp();
+  printf("Checking...\n");
+  time_check = check();
+
+  printf("Results:\n");
+  printf("cycles: id_check=%d, config=%d, exec=%d, check=%d\n", time_id, time_config, time_exec, time_check);
+  printf("ringlaunch completed normally\n");
+  return 0;
+}
@@ -0,0 +1,139 @@
+/*
+ * sls.cpp
+ *
+ * Copyright (C) 2017-2024 Tactical Computing Laboratories, LLC
+ * All Rights Reserved
+ * contact@tactcomplabs.com
+ *
+ * See LICENSE in the top level directory for licensing details
+ */
+
+// Standard includes
+#include <cinttypes>
+#include <cstdlib>
+#include <cstring>
+
+// PIM definitions
+#include "revpim.h"
+
+// Globals
+const int num_rows = 64;
+const int dim = 16;
+const int num_bags = 8;
+const uint64_t lengths[num_bags] = { 3, 1, 0, 5, 2, 4, 1, 6 };
+const int num_indices = 22;
+// int8 rows: dim values followed by an fp32 scale and bias
+const int q_row_bytes = dim + 8;
+
+// PIM Memories (non-cachable)
+float dram_table[num_rows * dim] __attribute__((section(".pimdram")));
+int8_t dram_qtable[num_rows * q_row_bytes] __attribute__((section(".pimdram")));
+uint64_t dram_indices[num_indices] __attribute__((section(".pimdram")));
+uint64_t dram_lengths[num_bags] __attribute__((section(".pimdram")));
+float dram_pooled[num_bags * dim] __attribute__((section(".pimdram")));
+float dram_qpooled[num_bags * dim] __attribute__((section(".pimdram")));
+uint64_t sram[PIM::SRAM_SIZE] __attribute__((section(".pimsram")));
+
+// SRAM layout: accumulator
+const int acc_idx = 8;
+
+uint64_t addr(const void* p) {
+  return reinterpret_cast<uint64_t>(p);
+}
+
+size_t checkPIM() {
+  size_t time1, time2;
+  // sram offset 0 initialized by PIM hardware
+  REV_TIME( time1 );
+  if (sram[0] != ( uint64_t( PIM_TYPE_TCL ) << 56 )) {
+    printf("Unexpected PIM TYPE 0x%lx\n", sram[0]);
+    assert(false);
+  }
+  REV_TIME( time2 );
+  return time2 - time1;
+}
+
+size_t configure() {
+  size_t time1, time2;
+  REV_TIME( time1 );
+  for (int r=0; r<num_rows; r++) {
+    float scale = 0.25f * float( 1 + r % 4 );
+    float bias = float( r % 3 ) - 1.0f;
+    for (int j=0; j<dim; j++) {
+      dram_table[r * dim + j] = float( ( r * 31 + j * 7 ) % 64 ) - 32.0f;
+      dram_qtable[r * q_row_bytes + j] = int8_t( ( r * 13 + j * 5 ) % 256 - 128 );
+    }
+    memcpy(&dram_qtable[r * q_row_bytes + dim], &scale, sizeof(scale));
+    memcpy(&dram_qtable[r * q_row_bytes + dim + 4], &bias, sizeof(bias));
+  }
+  for (int i=0; i<num_indices; i++)
+    dram_indices[i] = ( i * 37 ) % num_rows;
+  for (int b=0; b<num_bags; b++)
+    dram_lengths[b] = lengths[b];
+  REV_TIME( time2 );
+  return time2 - time1;
+}
+
+size_t theApp() {
+  size_t time1, time2;
+  REV_TIME( time1 );
+  revpim::init(PIM::FUNC_NUM::U13, addr(dram_pooled), addr(dram_table), addr(dram_indices), addr(dram_lengths),
+               num_bags, PIM::slsCtrl(PIM::EW_TYPE::F32, dim), addr(&sram[acc_idx]), 0);
+  revpim::run(PIM::FUNC_NUM::U13);
+  revpim::finish(PIM::FUNC_NUM::U13);
+  revpim::init(PIM::FUNC_NUM::U13, addr(dram_qpooled), addr(dram_qtable), addr(dram_indices), addr(dram_lengths),
+               num_bags, PIM::slsCtrl(PIM::EW_TYPE::I8, dim), addr(&sram[acc_idx]), 0);
+  revpim::run(PIM::FUNC_NUM::U13);
+  revpim::finish(PIM::FUNC_NUM::U13);
+  REV_TIME( time2 );
+  return time2 - time1;
+}
+
+size_t check() {
+  size_t time1, time2;
+  REV_TIME( time1 );
+  int k = 0;
+  for (int b=0; b<num_bags; b++) {
+    float sum[dim] = { 0 };
+    float qsum[dim] = { 0 };
+    for (uint64_t i=0; i<lengths[b]; i++, k++) {
+      int r = dram_indices[k];
+      float scale, bias;
+      memcpy(&scale, &dram_qtable[r * q_row_bytes + dim], sizeof(scale));
+      memcpy(&bias, &dram_qtable[r * q_row_bytes + dim + 4], sizeof(bias));
+      for (int j=0; j<dim; j++) {
+        sum[j] += dram_table[r * dim + j];
+        qsum[j] += scale * float( dram_qtable[r * q_row_bytes + j] ) + bias;
+      }
+    }
+    for (int j=0; j<dim; j++) {
+      if (dram_pooled[b * dim + j] != sum[j] || dram_qpooled[b * dim + j] != qsum[j]) {
+        printf("Failed: bag %d element %d\n", b, j);
+        assert(false);
+      }
+    }
+  }
+  REV_TIME( time2 );
+  return time2 - time1;
+}
+
+int main( int argc, char** argv ) {
+  printf("Starting sls\n");
+  size_t time_id, time_config, time_exec, time_check;
+
+  printf("\nsram=0x%lx\ndram_table=0x%lx\ndram_qtable=0x%lx\ndram_pooled=0x%lx\nnum_bags=%d\n", addr(sram), addr(dram_table), addr(dram_qtable), addr(dram_pooled), num_bags);
+
+  printf("Checking PIM ID...\n");
+  time_id = checkPIM();
+  printf("Configuring...\n");
+  time_config = configure();
+  printf("Executing...\n");
+  time_exec = theApp();
+  printf("Checking...\n");
+  time_check = check();
+
+  printf("Results:\n");
+  printf("cycles: id_check=%d, config=%d, exec=%d, check=%d\n", time_id, time_config, time_exec, time_check);
+  printf("sls completed normally\n");
+  return 0;
+}
@@ -0,0 +1,108 @@
+/*
+ * sort.cpp
+ *
+ * Copyright (C) 2017-2024 Tactical Computing Laboratories, LLC
+ * All Rights Reserved
+ * contact@tactcomplabs.com
+ *
+ * See LICENSE in the top level directory for licensing details
+ */
+
+// Standard includes
+#include <cinttypes>
+#include <cstdlib>
+#include <cstring>
+
+// PIM definitions
+#include "revpim.h"
+
+// Globals
+const int num_records = 300;    // several SRAM tiles, so merge passes run
+
+// PIM Memories (non-cachable)
+struct record_t {
+  uint64_t key;
+  uint64_t value;
+};
+record_t dram_src[num_records] __attribute__((section(".pimdram")));
+record_t dram_dst[num_records] __attribute__((section(".pimdram")));
+record_t dram_tmp[num_records] __attribute__((section(".pimdram")));
+uint64_t sram[PIM::SRAM_SIZE] __attribute__((section(".pimsram")));
+
+// SRAM layout: the tile runs from here to the end of SRAM
+const int tile_idx = 8;
+
+uint64_t addr(const void* p) {
+  return reinterpret_cast<uint64_t>(p);
+}
+
+size_t checkPIM() {
+  size_t time1, time2;
+  // sram offset 0 initialized by PIM hardware
+  REV_TIME( time1 );
+  if (sram[0] != ( uint64_t( PIM_TYPE_TCL ) << 56 )) {
+    printf("Unexpected PIM TYPE 0x%lx\n", sram[0]);
+    assert(false);
+  }
+  REV_TIME( time2 );
+  return time2 - time1;
+}
+
+size_t configure() {
+  size_t time1, time2;
+  REV_TIME( time1 );
+  // Keys repeat so stability is checked through the values
+  for (int i=0; i<num_records ;i++) {
+    dram_src[i].key = ( uint64_t(i) * 7919 ) % 97;
+    dram_src[i].value = i;
+  }
+  REV_TIME( time2 );
+  return time2 - time1;
+}
+
+size_t theApp() {
+  size_t time1, time2;
+  REV_TIME( time1 );
+  revpim::init(PIM::FUNC_NUM::U6, addr(dram_dst), addr(dram_src), addr(dram_tmp), num_records,
+               PIM::sortCtrl(true, PIM::SORT_NET::BITONIC), addr(&sram[tile_idx]), 0);
+  revpim::run(PIM::FUNC_NUM::U6);
+  revpim::finish(PIM::FUNC_NUM::U6);
+  REV_TIME( time2 );
+  return time2 - time1;
+}
+
+size_t check() {
+  size_t time1, time2;
+  REV_TIME( time1 );
+  for (int i=1; i<num_records; i++) {
+    const record_t& a = dram_dst[i-1];
+    const record_t& b = dram_dst[i];
+    if (a.key > b.key || (a.key == b.key && a.value >= b.value)) {
+      printf("Failed: record %d {0x%lx, %ld} after {0x%lx, %ld}\n", i, b.key, b.value, a.key, a.value);
+      assert(false);
+    }
+  }
+  REV_TIME( time2 );
+  return time2 - time1;
+}
+
+int main( int argc, char** argv ) {
+  printf("Starting sort\n");
+  size_t time_id, time_config, time_exec, time_check;
+
+  printf("\nsram=0x%lx\ndram_src=0x%lx\ndram_dst=0x%lx\nnum_records=%d\n", addr(sram), addr(dram_src), addr(dram_dst), num_records);
+
+  printf("Checking PIM ID...\n");
+  time_id = checkPIM();
+  printf("Configuring...\n");
+  time_config = configure();
+  printf("Executing...\n");
+  time_exec = theApp();
+  printf("Checking...\n");
+  time_check = check();
+
+  printf("Results:\n");
+  printf("cycles: id_check=%d, config=%d, exec=%d, check=%d\n", time_id, time_config, time_exec, time_check);
+  printf("sort completed normally\n");
+  return 0;
+}
@@ -0,0 +1,120 @@
+/*
+ * spmv.cpp
+ *
+ * Copyright (C) 2017-2024 Tactical Computing Laboratories, LLC
+ * All Rights Reserved
+ * contact@tactcomplabs.com
+ *
+ * See LICENSE in the top level directory for licensing details
+ */
+
+// Standard includes
+#include <cinttypes>
+#include <cstdlib>
+#include <cstring>
+
+// PIM definitions
+#include "revpim.h"
+
+// Globals
+const int num_rows = 200;       // more rows than SRAM row sums, so several blocks
+const int band = 2;             // nonzeros at col - band .. col + band
+const int max_nnz = num_rows * ( 2 * band + 1 );
+const uint64_t cache_bytes = 512;
+double check_y[num_rows];
+
+// PIM Memories (non-cachable)
+uint64_t dram_row_ptr[num_rows + 1] __attribute__((section(".pimdram")));
+uint64_t dram_col_idx[max_nnz] __attribute__((section(".pimdram")));
+double   dram_values[max_nnz] __attribute__((section(".pimdram")));
+double   dram_x[num_rows] __attribute__((section(".pimdram")));
+double   dram_y[num_rows] __attribute__((section(".pimdram")));
+uint64_t sram[PIM::SRAM_SIZE] __attribute__((section(".pimsram")));
+
+// SRAM layout: row sums, then the x cache at the end
+const int scratch_idx = 8;
+
+uint64_t addr(const void* p) {
+  return reinterpret_cast<uint64_t>(p);
+}
+
+size_t checkPIM() {
+  size_t time1, time2;
+  // sram offset 0 initialized by PIM hardware
+  REV_TIME( time1 );
+  if (sram[0] != ( uint64_t( PIM_TYPE_TCL ) << 56 )) {
+    printf("Unexpected PIM TYPE 0x%lx\n", sram[0]);
+    assert(false);
+  }
+  REV_TIME( time2 );
+  return time2 - time1;
+}
+
+size_t configure() {
+  size_t time1, time2;
+  REV_TIME( time1 );
+  // Banded matrix with small integer entries so sums are exact
+  for (int c=0; c<num_rows ;c++)
+    dram_x[c] = double( c % 11 ) - 5;
+  uint64_t k = 0;
+  for (int r=0; r<num_rows ;r++) {
+    dram_row_ptr[r] = k;
+    check_y[r] = 0;
+    for (int c=r-band; c<=r+band ;c++) {
+      if (c < 0 || c >= num_rows)
+        continue;
+      dram_col_idx[k] = c;
+      dram_values[k] = double( ( r + 2 * c ) % 5 ) - 2;
+      check_y[r] += dram_values[k] * dram_x[c];
+      k++;
+    }
+  }
+  dram_row_ptr[num_rows] = k;
+  REV_TIME( time2 );
+  return time2 - time1;
+}
+
+size_t theApp() {
+  size_t time1, time2;
+  REV_TIME( time1 );
+  revpim::init(PIM::FUNC_NUM::U9, addr(dram_y), addr(dram_row_ptr), addr(dram_col_idx), addr(dram_values),
+               addr(dram_x), num_rows, addr(&sram[scratch_idx]), cache_bytes);
+  revpim::run(PIM::FUNC_NUM::U9);
+  revpim::finish(PIM::FUNC_NUM::U9);
+  REV_TIME( time2 );
+  return time2 - time1;
+}
+
+size_t check() {
+  size_t time1, time2;
+  REV_TIME( time1 );
+  for (int r=0; r<num_rows; r++) {
+    if (dram_y[r] != check_y[r]) {
+      printf("Failed: y[%d]=%f expected %f\n", r, dram_y[r], check_y[r]);
+      assert(false);
+    }
+  }
+  REV_TIME( time2 );
+  return time2 - time1;
+}
+
+int main( int argc, char** argv ) {
+  printf("Starting spmv\n");
+  size_t time_id, time_config, time_exec, time_check;
+
+  printf("\nsram=0x%lx\ndram_x=0x%lx\ndram_y=0x%lx\nnum_rows=%d\n", addr(sram), addr(dram_x), addr(dram_y), num_rows);
+
+  printf("Checking PIM ID...\n");
+  time_id = checkPIM();
+  printf("Configuring...\n");
+  time_config = configure();
+  printf("Executing...\n");
+  time_exec = theApp();
+  printf("Checking...\n");
+  time_check = check();
+
+  printf("Results:\n");
+  printf("cycles: id_check=%d, config=%d, exec=%d, check=%d\n", time_id, time_config, time_exec, time_check);
+  printf("spmv completed normally\n");
+  return 0;
+}
@@ -0,0 +1,111 @@
+/*
+ * stencil.cpp
+ *
+ * Copyright (C) 2017-2024 Tactical Computing Laboratories, LLC
+ * All Rights Reserved
+ * contact@tactcomplabs.com
+ *
+ * See LICENSE in the top level directory for licensing details
+ */
+
+// Standard includes
+#include <cinttypes>
+#include <cstdlib>
+#include <cstring>
+
+// PIM definitions
+#include "revpim.h"
+
+// Globals
+const int rows = 32;
+const int cols = 48;
+// center, west, east, north, south
+const double coef[5] = { 0.5, 0.125, 0.125, 0.125, 0.125 };
+
+// PIM Memories (non-cachable)
+double dram_src[rows][cols] __attribute__((section(".pimdram")));
+double dram_dst[rows][cols] __attribute__((section(".pimdram")));
+uint64_t sram[PIM::SRAM_SIZE] __attribute__((section(".pimsram")));
+
+// SRAM layout: coefficients, then the row ring to the end of SRAM
+const int coef_idx = 8;
+const int ring_idx = 16;
+
+uint64_t addr(const void* p) {
+  return reinterpret_cast<uint64_t>(p);
+}
+
+size_t checkPIM() {
+  size_t time1, time2;
+  // sram offset 0 initialized by PIM hardware
+  REV_TIME( time1 );
+  if (sram[0] != ( uint64_t( PIM_TYPE_TCL ) << 56 )) {
+    printf("Unexpected PIM TYPE 0x%lx\n", sram[0]);
+    assert(false);
+  }
+  REV_TIME( time2 );
+  return time2 - time1;
+}
+
+size_t configure() {
+  size_t time1, time2;
+  REV_TIME( time1 );
+  for (int r=0; r<rows; r++)
+    for (int c=0; c<cols; c++)
+      dram_src[r][c] = double( ( r * 7 + c * 3 ) % 32 ) - 16.0;
+  memcpy(&sram[coef_idx], coef, sizeof(coef));
+  REV_TIME( time2 );
+  return time2 - time1;
+}
+
+size_t theApp() {
+  size_t time1, time2;
+  REV_TIME( time1 );
+  revpim::init(PIM::FUNC_NUM::U17, addr(dram_dst), addr(dram_src), rows, cols,
+               PIM::stencilCtrl(PIM::STENCIL::POINT5, PIM::EW_TYPE::F64), addr(&sram[coef_idx]), addr(&sram[ring_idx]), 0);
+  revpim::run(PIM::FUNC_NUM::U17);
+  revpim::finish(PIM::FUNC_NUM::U17);
+  REV_TIME( time2 );
+  return time2 - time1;
+}
+
+size_t check() {
+  size_t time1, time2;
+  REV_TIME( time1 );
+  for (int r=0; r<rows; r++) {
+    for (int c=0; c<cols; c++) {
+      double e = dram_src[r][c];
+      if (r > 0 && r < rows - 1 && c > 0 && c < cols - 1)
+        e = coef[0] * dram_src[r][c] + coef[1] * dram_src[r][c - 1] + coef[2] * dram_src[r][c + 1] +
+            coef[3] * dram_src[r - 1][c] + coef[4] * dram_src[r + 1][c];
+      double d = dram_dst[r][c] - e;
+      if (d > 1e-9 || d < -1e-9) {
+        printf("Failed: [%d][%d] %f expected %f\n", r, c, dram_dst[r][c], e);
+        assert(false);
+      }
+    }
+  }
+  REV_TIME( time2 );
+  return time2 - time1;
+}
+
+int main( int argc, char** argv ) {
+  printf("Starting stencil\n");
+  size_t time_id, time_config, time_exec, time_check;
+
+  printf("\nsram=0x%lx\ndram_src=0x%lx\ndram_dst=0x%lx\nrows=%d cols=%d\n", addr(sram), addr(dram_src), addr(dram_dst), rows, cols);
+
+  printf("Checking PIM ID...\n");
+  time_id = checkPIM();
+  printf("Configuring...\n");
+  time_config = configure();
+  printf("Executing...\n");
+  time_exec = theApp();
+  printf("Checking...\n");
+  time_check = check();
+
+  printf("Results:\n");
+  printf("cycles: id_check=%d, config=%d, exec=%d, check=%d\n", time_id, time_config, time_exec, time_check);
+  printf("stencil completed normally\n");
+  return 0;
+}
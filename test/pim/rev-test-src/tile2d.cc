@@ -0,0 +1,140 @@
+/*
+ * tile2d.cpp
+ *
+ * Copyright (C) 2017-2024 Tactical Computing Laboratories, LLC
+ * All Rights Reserved
+ * contact@tactcomplabs.com
+ *
+ * See LICENSE in the top level directory for licensing details
+ */
+
+// Standard includes
+#include <cinttypes>
+#include <cstdlib>
+#include <cstring>
+
+// PIM definitions
+#include "revpim.h"
+
+// Globals
+const int dim = 32;        // source matrix is dim x dim dwords
+const int tile = 8;        // tile is tile x tile dwords
+const int tile_row = 5;
+const int tile_col = 12;
+
+// 24-byte records. A row of them spans more than one 512-byte DMA chunk,
+// so some records straddle two chunks.
+struct rec_t { uint64_t x, y, z; };
+const int rec_rows = 2;
+const int rec_cols = 32;
+
+// PIM Memories (non-cachable)
+uint64_t dram_mat[dim * dim] __attribute__((section(".pimdram")));
+uint64_t dram_out[tile * tile] __attribute__((section(".pimdram")));
+rec_t dram_aos[rec_rows][rec_cols] __attribute__((section(".pimdram")));
+rec_t dram_soa[rec_cols][rec_rows] __attribute__((section(".pimdram")));
+uint64_t sram[PIM::SRAM_SIZE] __attribute__((section(".pimsram")));
+
+// SRAM layout: tile staged after the PIM id word
+const int tile_idx = 8;
+
+uint64_t addr(const void* p) {
+  return reinterpret_cast<uint64_t>(p);
+}
+
+size_t checkPIM() {
+  size_t time1, time2;
+  // sram offset 0 initialized by PIM hardware
+  REV_TIME( time1 );
+  if (sram[0] != ( uint64_t( PIM_TYPE_TCL ) << 56 )) {
+    printf("Unexpected PIM TYPE 0x%lx\n", sram[0]);
+    assert(false);
+  }
+  REV_TIME( time2 );
+  return time2 - time1;
+}
+
+size_t configure() {
+  size_t time1, time2;
+  REV_TIME( time1 );
+  for (int r=0; r<dim ;r++)
+    for (int c=0; c<dim ;c++)
+      dram_mat[r * dim + c] = (uint64_t(r) << 16) | c;
+  for (int r=0; r<rec_rows ;r++)
+    for (int c=0; c<rec_cols ;c++)
+      dram_aos[r][c] = { (uint64_t(r) << 16) | c, uint64_t(r * rec_cols + c), ~uint64_t(c) };
+  REV_TIME( time2 );
+  return time2 - time1;
+}
+
+size_t theApp() {
+  size_t time1, time2;
+  const size_t row_bytes = tile * sizeof(uint64_t);
+  REV_TIME( time1 );
+  // One launch stages the whole tile in SRAM
+  revpim::init(PIM::FUNC_NUM::F5, addr(&sram[tile_idx]), addr(&dram_mat[tile_row * dim + tile_col]),
+               tile, row_bytes, dim * sizeof(uint64_t), 0, 0);
+  revpim::run(PIM::FUNC_NUM::F5);
+  revpim::finish(PIM::FUNC_NUM::F5);
+  // and one writes it back transposed
+  revpim::init(PIM::FUNC_NUM::F5, addr(dram_out), addr(&sram[tile_idx]),
+               tile, row_bytes, 0, 0, sizeof(uint64_t));
+  revpim::run(PIM::FUNC_NUM::F5);
+  revpim::finish(PIM::FUNC_NUM::F5);
+  // Transpose whole records
+  revpim::init(PIM::FUNC_NUM::F5, addr(dram_soa), addr(dram_aos),
+               rec_rows, rec_cols * sizeof(rec_t), 0, 0, sizeof(rec_t));
+  revpim::run(PIM::FUNC_NUM::F5);
+  revpim::finish(PIM::FUNC_NUM::F5);
+  REV_TIME( time2 );
+  return time2 - time1;
+}
+
+size_t check() {
+  size_t time1, time2;
+  REV_TIME( time1 );
+  for (int r=0; r<tile; r++) {
+    for (int c=0; c<tile; c++) {
+      uint64_t expect = dram_mat[(tile_row + r) * dim + tile_col + c];
+      if (sram[tile_idx + r * tile + c] != expect) {
+        printf("Failed: tile[%d][%d]=0x%lx expected 0x%lx\n", r, c, sram[tile_idx + r * tile + c], expect);
+        assert(false);
+      }
+      if (dram_out[c * tile + r] != expect) {
+        printf("Failed: out[%d][%d]=0x%lx expected 0x%lx\n", c, r, dram_out[c * tile + r], expect);
+        assert(false);
+      }
+    }
+  }
+  for (int r=0; r<rec_rows; r++) {
+    for (int c=0; c<rec_cols; c++) {
+      if (memcmp(&dram_soa[c][r], &dram_aos[r][c], sizeof(rec_t)) != 0) {
+        printf("Failed: soa[%d][%d].x=0x%lx expected 0x%lx\n", c, r, dram_soa[c][r].x, dram_aos[r][c].x);
+        assert(false);
+      }
+    }
+  }
+  REV_TIME( time2 );
+  return time2 - time1;
+}
+
+int main( int argc, char** argv ) {
+  printf("Starting tile2d\n");
+  size_t time_id, time_config, time_exec, time_check;
+
+  printf("\nsram=0x%lx\ndram_mat=0x%lx\ndim=%d\ntile=%d\n", addr(sram), addr(dram_mat), dim, tile);
+
+  printf("Checking PIM ID...\n");
+  time_id = checkPIM();
+  printf("Configuring...\n");
+  time_config = configure();
+  printf("Executing...\n");
+  time_exec = theApp();
+  printf("Checking...\n");
+  time_check = check();
+
+  printf("Results:\n");
+  printf("cycles: id_check=%d, config=%d, exec=%d, check=%d\n", time_id, time_config, time_exec, time_check);
+  printf("tile2d completed normally\n");
+  return 0;
+}
@@ -76,7 +76,7 @@ size_t theApp() {
   REV_TIME( time1 );
   revpim::init(PIM::FUNC_NUM::U5, dram_dst, dram_src, scalar, xfr_size*sizeof(uint64_t));
   revpim::run(PIM::FUNC_NUM::U5);
-  revpim::finish(PIM::FUNC_NUM::U5); // blocking polling loop :(
+  revpim::finish(PIM::FUNC_NUM::U5); // single blocking status read
   REV_TIME( time2 );
   return time2 - time1;
 }